@@ -106,6 +106,7 @@ protected:
 private:
     void updateState(QAbstractAnimation::State newState, QAbstractAnimation::State oldState) override;
     void updateCurrentTime(int currentTime) override;
+    void onFrame();
     void onStateChanged(QGV::MapState state);
 
 private:
@@ -38,10 +38,15 @@ public:
 
     void refresh();
     void repaint();
+    void repaint(const QRectF& projRect);
     void resetBoundary();
     QTransform effectiveTransform() const;
 
+    void setCacheMode(QGraphicsItem::CacheMode mode);
+    QGraphicsItem::CacheMode getCacheMode() const;
+
     virtual QPainterPath projShape() const = 0;
+    virtual QRectF projBoundingRect() const;
     virtual void projPaint(QPainter* painter) = 0;
     virtual QPointF projAnchor() const;
     virtual QTransform projTransform() const;
@@ -60,8 +65,12 @@ protected:
     void onUpdate() override;
     void onClean() override;
 
+private:
+    bool isScreenSpace() const;
+
 private:
     QGV::ItemFlags mFlags;
     QScopedPointer<QGVMapQGItem> mQGDrawItem;
+    QGraphicsItem::CacheMode mCacheMode;
     bool mDirty;
 };
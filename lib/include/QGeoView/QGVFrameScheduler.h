@@ -0,0 +1,65 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGVGlobal.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include <functional>
+
+// Fixed-rate task coalescer, not synchronized with display refresh or view painting.
+// Timer runs only while tasks are pending, each owner keeps its latest task until next tick.
+class QGV_LIB_DECL QGVFrameScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QGVFrameScheduler(QObject* parent = nullptr);
+
+    void setFrameInterval(int msecs);
+    int getFrameInterval() const;
+    void setFrameBudget(int msecs);
+    int getFrameBudget() const;
+
+    void schedule(QObject* owner, const std::function<void()>& task);
+    void cancel(QObject* owner);
+    void flush(QObject* owner);
+    bool isScheduled(QObject* owner) const;
+
+private:
+    void onFrame();
+
+private:
+    struct Task
+    {
+        QPointer<QObject> owner;
+        std::function<void()> func;
+    };
+
+    QTimer mTimer;
+    int mFrameBudget;
+    QHash<QObject*, Task> mTasks;
+    QList<QObject*> mOrder;
+};
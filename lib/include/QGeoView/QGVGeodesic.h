@@ -0,0 +1,74 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGVGlobal.h"
+
+#include <QVector>
+
+namespace QGV {
+
+QGV_LIB_DECL double geodesicDistance(const GeoPos& from,
+                                     const GeoPos& to,
+                                     GeodesicMethod method = GeodesicMethod::Haversine);
+QGV_LIB_DECL double geodesicBearing(const GeoPos& from, const GeoPos& to);
+QGV_LIB_DECL GeoPos geodesicDestination(const GeoPos& from,
+                                        double bearing,
+                                        double meters,
+                                        GeodesicMethod method = GeodesicMethod::Haversine);
+QGV_LIB_DECL void geodesicDestinations(const GeoPos& from,
+                                       const double* bearings,
+                                       const double* meters,
+                                       double* lat,
+                                       double* lon,
+                                       int count,
+                                       GeodesicMethod method = GeodesicMethod::Haversine);
+
+} // namespace QGV
+
+class QGV_LIB_DECL QGVGeodesicPoints
+{
+public:
+    QGVGeodesicPoints();
+    QGVGeodesicPoints(const double* lat, const double* lon, int count);
+
+    void setPoints(const double* lat, const double* lon, int count);
+    int countPoints() const;
+
+    void distances(const QGV::GeoPos& origin,
+                   double* meters,
+                   QGV::GeodesicMethod method = QGV::GeodesicMethod::Haversine) const;
+    void bearings(const QGV::GeoPos& origin, double* degrees) const;
+    QVector<int> within(const QGV::GeoPos& origin, double meters) const;
+    int nearest(const QGV::GeoPos& origin) const;
+
+private:
+    void haversine(const QGV::GeoPos& origin, double* meters, int from, int to) const;
+    void vincenty(const QGV::GeoPos& origin, double* meters, int from, int to) const;
+
+private:
+    QVector<double> mLatRad;
+    QVector<double> mLonRad;
+    QVector<double> mSinLat;
+    QVector<double> mCosLat;
+    QVector<double> mSinLon;
+    QVector<double> mCosLon;
+    QVector<double> mSinU;
+    QVector<double> mCosU;
+};
@@ -23,6 +23,7 @@
 #include <QPainterPath>
 #include <QPointF>
 #include <QRectF>
+#include <QVector>
 
 #ifndef QGV_LIB_DECL
 #if defined(QGV_EXPORT)
@@ -32,11 +33,14 @@
 #endif
 #endif
 
+class QGVProjection;
+
 namespace QGV {
 
 enum class Projection
 {
     EPSG3857,
+    EPSG4326,
 };
 
 enum class TilesType
@@ -74,6 +78,12 @@ enum class DistanceUnits
     Miles,
 };
 
+enum class GeodesicMethod
+{
+    Haversine,
+    Vincenty,
+};
+
 enum class MouseAction : int
 {
     Move = 0x1,
@@ -165,12 +175,16 @@ public:
     GeoTilePos& operator=(const GeoTilePos&& other);
 
     bool operator<(const GeoTilePos& other) const;
+    bool operator==(const GeoTilePos& other) const;
+    bool operator!=(const GeoTilePos& other) const;
 
     int zoom() const;
     QPoint pos() const;
+    quint64 mortonKey() const;
 
     bool contains(const GeoTilePos& other) const;
     GeoTilePos parent(int parentZoom) const;
+    QRect childRect(int childZoom) const;
 
     GeoRect toGeoRect() const;
     QString toQuadKey() const;
@@ -182,7 +196,50 @@ private:
     QPoint mPos;
 };
 
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+QGV_LIB_DECL size_t qHash(const GeoTilePos& key, size_t seed = 0);
+#else
+QGV_LIB_DECL uint qHash(const GeoTilePos& key, uint seed = 0);
+#endif
+
+class QGV_LIB_DECL GeoPosArray
+{
+public:
+    GeoPosArray();
+    explicit GeoPosArray(const QVector<GeoPos>& geoPoints);
+
+    int size() const;
+    bool isEmpty() const;
+    void reserve(int size);
+    void clear();
+
+    void append(double lat, double lon);
+    void append(const GeoPos& geoPos);
+    void set(int index, double lat, double lon);
+
+    GeoPos at(int index) const;
+    double latitude(int index) const;
+    double longitude(int index) const;
+    const qint32* latitudeData() const;
+    const qint32* longitudeData() const;
+
+    void toDegrees(int from, int count, double* lat, double* lon) const;
+    void toProj(const QGVProjection* projection, double* x, double* y) const;
+    QVector<GeoPos> toVector() const;
+
+    static constexpr double unitsPerDegree = 1e7;
+
+private:
+    static qint32 toUnits(double degrees);
+
+private:
+    QVector<qint32> mLat;
+    QVector<qint32> mLon;
+};
+
 QGV_LIB_DECL void setNetworkManager(QNetworkAccessManager* manager);
+
+QGV_LIB_DECL int scaleToZoom(double scale);
 QGV_LIB_DECL QNetworkAccessManager* getNetworkManager();
 
 QGV_LIB_DECL QTransform createTransfrom(QPointF const& projAnchor, double scale, double azimuth);
@@ -65,16 +65,32 @@ public:
     void show();
     void hide();
 
+    void setAutoHidden(bool hidden);
+    bool isAutoHidden() const;
+
+    // Only camera dependent items receive onCamera, overrides must enable it
+    void setCameraDependent(bool dependent);
+    bool isCameraDependent() const;
+
     double effectiveZValue() const;
     double effectiveOpacity() const;
     bool effectivelyVisible() const;
 
     void update();
+    void applyProjection(QGVMap* geoMap);
 
+    virtual void onProjectionPrepare(const QGVProjection* projection);
     virtual void onProjection(QGVMap* geoMap);
     virtual void onCamera(const QGVCameraState& oldState, const QGVCameraState& newState);
     virtual void onUpdate();
     virtual void onClean();
+    virtual void onChildAdded(QGVItem* item);
+    virtual void onChildRemoved(QGVItem* item);
+    virtual void onChildGeometry(QGVItem* item);
+
+private:
+    void updateCameraItems(QGVMap* oldMap, QGVMap* newMap);
+    void collectItems(QVector<QGVItem*>& items);
 
 private:
     Q_DISABLE_COPY(QGVItem)
@@ -82,7 +98,9 @@ private:
     qint16 mZValue;
     double mOpacity;
     bool mVisible;
+    bool mAutoHidden;
     bool mSelectable;
     bool mSelected;
+    bool mCameraDependent;
     QList<QGVItem*> mChildrens;
 };
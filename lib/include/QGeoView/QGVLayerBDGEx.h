@@ -35,6 +35,7 @@ private:
     int minZoomlevel() const override;
     int maxZoomlevel() const override;
     QString tilePosToUrl(const QGV::GeoTilePos& tilePos) const override;
+    QGV::Projection tileProjection() const override;
 
 private:
     QString mUrl;
@@ -0,0 +1,86 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGVLayer.h"
+
+#include <QColor>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+class QGVDrawItem;
+
+class QGV_LIB_DECL QGVLayerClusters : public QGVLayer
+{
+    Q_OBJECT
+
+public:
+    QGVLayerClusters();
+
+    void setCellSize(int pixels);
+    int getCellSize() const;
+
+    void setClusterColor(const QColor& color);
+    QColor getClusterColor() const;
+
+    int getZoom() const;
+    int countClusters() const;
+
+protected:
+    void onProjection(QGVMap* geoMap) override;
+    void onCamera(const QGVCameraState& oldState, const QGVCameraState& newState) override;
+    void onChildAdded(QGVItem* item) override;
+    void onChildRemoved(QGVItem* item) override;
+    void onChildGeometry(QGVItem* item) override;
+
+private:
+    struct Cluster
+    {
+        QVector<QGVItem*> items;
+        QPointF projSum;
+    };
+
+    struct Level
+    {
+        double cellSize;
+        QHash<quint64, Cluster> cells;
+        QHash<QGVItem*, quint64> itemCells;
+    };
+
+    Level& level(int zoom);
+    quint64 insertToLevel(Level& level, QGVItem* item, const QPointF& projPos);
+    quint64 removeFromLevel(Level& level, QGVItem* item, const QPointF& projPos);
+    void updateCluster(const Level& level, quint64 key);
+    void setHidden(QGVItem* item, bool hidden);
+    void applyLevel();
+    void rebuild();
+    QRectF projBoundingRect() const;
+    void projPaint(QPainter* painter);
+
+private:
+    QGVDrawItem* mItem;
+    int mCellSize;
+    QColor mClusterColor;
+    int mZoom;
+    bool mRebuilding;
+    QHash<QGVItem*, QPointF> mItemPos;
+    QHash<int, Level> mLevels;
+    QSet<QGVItem*> mHidden;
+};
@@ -0,0 +1,85 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGVLayerTiles.h"
+
+#include <QAtomicInt>
+#include <QBrush>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QVector>
+
+struct QGVLayerHeatmapData;
+struct QGVLayerHeatmapStyle;
+class QGVLayerHeatmapTask;
+
+class QGV_LIB_DECL QGVLayerHeatmap : public QGVLayerTiles
+{
+    Q_OBJECT
+
+public:
+    QGVLayerHeatmap();
+    ~QGVLayerHeatmap();
+
+    void setPoints(const double* lats, const double* lons, const double* weights, int count);
+    void clearPoints();
+    int countPoints() const;
+
+    void setRadius(int pixels);
+    int getRadius() const;
+
+    void setMaxWeight(double weight);
+    double getMaxWeight() const;
+
+    void setGradient(const QGradientStops& stops);
+    QGradientStops getGradient() const;
+
+protected:
+    void onProjection(QGVMap* geoMap) override;
+    int minZoomlevel() const override;
+    int maxZoomlevel() const override;
+    void request(const QGV::GeoTilePos& tilePos) override;
+    void cancel(const QGV::GeoTilePos& tilePos) override;
+
+private:
+    void updateData();
+    void updateStyle();
+    void resetTiles();
+    void onTileRendered(const QGV::GeoTilePos& tilePos,
+                        const QSharedPointer<QAtomicInt>& token,
+                        const QImage& image);
+
+private:
+    friend class QGVLayerHeatmapTask;
+
+    int mRadius;
+    double mMaxWeight;
+    QGradientStops mGradient;
+    QGV::GeoPosArray mGeoPoints;
+    QVector<float> mWeights;
+    QSharedPointer<const QGVLayerHeatmapData> mData;
+    QSharedPointer<const QGVLayerHeatmapStyle> mStyle;
+    QHash<QGV::GeoTilePos, QSharedPointer<QAtomicInt>> mRequests;
+    QCache<quint64, QImage> mCache;
+    QThreadPool mPool;
+};
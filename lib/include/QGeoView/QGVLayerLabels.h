@@ -0,0 +1,84 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGVLayer.h"
+
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QStaticText>
+#include <QVector>
+
+class QGVDrawItem;
+
+class QGV_LIB_DECL QGVLayerLabels : public QGVLayer
+{
+    Q_OBJECT
+
+public:
+    QGVLayerLabels();
+
+    int addLabel(const QGV::GeoPos& geoPos, const QString& text, int priority = 0);
+    void removeLabel(int id);
+    void clearLabels();
+    int countLabels() const;
+
+    void setFont(const QFont& font);
+    QFont getFont() const;
+
+    void setColor(const QColor& color);
+    QColor getColor() const;
+
+    int countPlaced() const;
+
+protected:
+    void onProjection(QGVMap* geoMap) override;
+
+private:
+    struct Label
+    {
+        QGV::GeoPos geoPos;
+        QPointF projPos;
+        QStaticText text;
+        int priority;
+    };
+
+    struct Placement
+    {
+        int id;
+        QPointF offset;
+    };
+
+    void invalidatePlacements();
+    const QVector<Placement>& placements(int bucket, double azimuth);
+    QRectF projBoundingRect() const;
+    void projPaint(QPainter* painter);
+
+private:
+    QGVDrawItem* mItem;
+    QFont mFont;
+    QColor mColor;
+    int mNextId;
+    QHash<int, Label> mLabels;
+    QVector<int> mOrder;
+    double mAzimuth;
+    QHash<int, QVector<Placement>> mPlacements;
+    int mLastBucket;
+};
@@ -0,0 +1,109 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGVLayer.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+
+class QGV_LIB_DECL QGVLayerPlayback : public QGVLayer
+{
+    Q_OBJECT
+
+public:
+    QGVLayerPlayback();
+
+    void addFeature(QGVItem* item, qint64 from, qint64 to);
+    void setFeatureInterval(QGVItem* item, qint64 from, qint64 to);
+    int countFeatures() const;
+    int countActive() const;
+
+    void setTime(qint64 time);
+    qint64 getTime() const;
+
+    void setRate(double rate);
+    double getRate() const;
+
+    void setTickInterval(int msecs);
+    int getTickInterval() const;
+
+    void play();
+    void pause();
+    bool isPlaying() const;
+
+Q_SIGNALS:
+    void timeChanged(qint64 time);
+
+protected:
+    void onChildRemoved(QGVItem* item) override;
+
+private:
+    struct Feature
+    {
+        QGVItem* item;
+        qint64 from;
+        qint64 to;
+    };
+
+    struct Boundary
+    {
+        qint64 time;
+        int feature;
+    };
+
+    struct TreeNode
+    {
+        qint64 center;
+        int left;
+        int right;
+        QVector<int> byStart;
+        QVector<int> byEnd;
+    };
+
+    void onTick();
+    void rebuildIndex();
+    int buildTree(QVector<int>& features);
+    void queryTree(qint64 time, QVector<int>& result) const;
+    void sweep(qint64 fromTime, qint64 toTime);
+    void seek(qint64 time);
+    void setActive(int feature, bool active);
+    void setHidden(QGVItem* item, bool hidden);
+    bool isActiveAt(const Feature& feature, qint64 time) const;
+
+private:
+    QVector<Feature> mFeatures;
+    QHash<QGVItem*, int> mFeatureIndex;
+    QSet<int> mActive;
+    QSet<QGVItem*> mHidden;
+    bool mIndexDirty;
+    QVector<Boundary> mStarts;
+    QVector<Boundary> mEnds;
+    QVector<TreeNode> mTree;
+    int mTreeRoot;
+
+    qint64 mTime;
+    double mRate;
+    QTimer mTimer;
+    QElapsedTimer mClock;
+    qint64 mClockOrigin;
+};
@@ -0,0 +1,82 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGVLayer.h"
+
+#include <QColor>
+#include <QVector>
+
+class QGVDrawItem;
+
+class QGV_LIB_DECL QGVLayerPoints : public QGVLayer
+{
+    Q_OBJECT
+
+public:
+    QGVLayerPoints();
+
+    int addStyle(const QColor& color, double pixelSize);
+    int countStyles() const;
+
+    void setPoints(const double* lats, const double* lons, const quint8* styles, int count);
+    int appendPoints(const double* lats, const double* lons, const quint8* styles, int count);
+    void updatePoints(const int* indices, const double* lats, const double* lons, const double* headings, int count);
+    void clearPoints();
+    int countPoints() const;
+
+protected:
+    void onProjectionPrepare(const QGVProjection* projection) override;
+    void onProjection(QGVMap* geoMap) override;
+
+private:
+    void projectPoints(int from);
+    void calculateProjection(const QGVProjection* projection, int from);
+    void updateGrid();
+    void repaintPoints();
+    double maxPixelExtent() const;
+    QRectF projBoundingRect() const;
+    void projPaint(QPainter* painter);
+
+private:
+    struct Style
+    {
+        QColor color;
+        double size;
+    };
+
+    QGVDrawItem* mItem;
+    QVector<Style> mStyles;
+    QVector<double> mGeoLat;
+    QVector<double> mGeoLon;
+    QVector<double> mProjX;
+    QVector<double> mProjY;
+    QVector<double> mHeading;
+    QVector<quint8> mPointStyles;
+    QRectF mProjRect;
+
+    bool mGridDirty;
+    QRectF mGridRect;
+    int mGridSide;
+    QVector<int> mCellStart;
+    QVector<int> mCellPoints;
+    QVector<QVector<QPointF>> mPaintBatches;
+    QVector<QVector<QLineF>> mHeadingBatches;
+    const QGVProjection* mPreparedProjection;
+};
@@ -0,0 +1,71 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGVLayerTiles.h"
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QImage>
+#include <QSharedPointer>
+
+class QGVLayerRasterSource;
+class QGVLayerRasterTask;
+
+class QGV_LIB_DECL QGVLayerRaster : public QGVLayerTiles
+{
+    Q_OBJECT
+
+public:
+    QGVLayerRaster();
+    ~QGVLayerRaster();
+
+    void setSource(const QString& fileName, const QGV::GeoRect& geoRect);
+    QString getSource() const;
+    QGV::GeoRect getGeoRect() const;
+    QSize getSourceSize() const;
+
+    void setPersistentCache(bool enabled);
+    bool isPersistentCache() const;
+
+protected:
+    void onProjection(QGVMap* geoMap) override;
+    int minZoomlevel() const override;
+    int maxZoomlevel() const override;
+    void request(const QGV::GeoTilePos& tilePos) override;
+    void cancel(const QGV::GeoTilePos& tilePos) override;
+
+private:
+    void calculateGeometry();
+    void resetTiles();
+    void onTileRendered(const QGV::GeoTilePos& tilePos,
+                        const QSharedPointer<QAtomicInt>& token,
+                        const QImage& image);
+
+private:
+    friend class QGVLayerRasterTask;
+
+    QString mFileName;
+    QGV::GeoRect mGeoRect;
+    bool mPersistentCache;
+    QRectF mProjRect;
+    int mMaxZoom;
+    QSharedPointer<QGVLayerRasterSource> mSource;
+    QHash<QGV::GeoTilePos, QSharedPointer<QAtomicInt>> mRequests;
+};
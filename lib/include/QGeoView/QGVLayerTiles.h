@@ -21,6 +21,7 @@
 #include "QGVLayer.h"
 
 #include <QElapsedTimer>
+#include <QHash>
 
 class QGV_LIB_DECL QGVLayerTiles : public QGVLayer
 {
@@ -58,12 +59,13 @@ private:
     void removeTile(const QGV::GeoTilePos& tilePos);
     bool isTileExists(const QGV::GeoTilePos& tilePos) const;
     bool isTileFinished(const QGV::GeoTilePos& tilePos) const;
+    bool isTileInView(const QGV::GeoTilePos& tilePos) const;
     QList<QGV::GeoTilePos> existingTiles(int zoom) const;
 
 private:
     int mCurZoom;
     QRect mCurRect;
-    QMap<int, QMap<QGV::GeoTilePos, QGVDrawItem*>> mIndex;
+    QHash<int, QHash<QGV::GeoTilePos, QGVDrawItem*>> mIndex;
 
     QElapsedTimer mLastAnimation;
 
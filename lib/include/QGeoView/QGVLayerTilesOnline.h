@@ -20,7 +20,14 @@
 
 #include "QGVLayerTiles.h"
 
+#include <QAtomicInt>
+#include <QHash>
 #include <QNetworkReply>
+#include <QSharedPointer>
+#include <QThreadPool>
+
+class QGVImage;
+class QGVLayerTilesOnlineWarpTask;
 
 class QGV_LIB_DECL QGVLayerTilesOnline : public QGVLayerTiles
 {
@@ -31,13 +38,23 @@ public:
 
 protected:
     virtual QString tilePosToUrl(const QGV::GeoTilePos& tilePos) const = 0;
+    virtual QGV::Projection tileProjection() const;
 
 private:
     void request(const QGV::GeoTilePos& tilePos) override;
     void cancel(const QGV::GeoTilePos& tilePos) override;
     void onReplyFinished(QNetworkReply* reply, const QGV::GeoTilePos& tilePos);
+    void onTileWarped(const QGV::GeoTilePos& tilePos,
+                      const QSharedPointer<QAtomicInt>& token,
+                      const QImage& image,
+                      const QString& url);
+    void addTile(const QGV::GeoTilePos& tilePos, QGVImage* tile, const QString& url);
     void removeReply(const QGV::GeoTilePos& tilePos);
 
 private:
-    QMap<QGV::GeoTilePos, QNetworkReply*> mRequest;
+    friend class QGVLayerTilesOnlineWarpTask;
+
+    QHash<QGV::GeoTilePos, QNetworkReply*> mRequest;
+    QHash<QGV::GeoTilePos, QSharedPointer<QAtomicInt>> mWarps;
+    QThreadPool mWarpPool;
 };
@@ -0,0 +1,81 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGVLayer.h"
+
+#include <QHash>
+#include <QPen>
+#include <QVector>
+
+class QGVDrawItem;
+
+class QGV_LIB_DECL QGVLayerTrails : public QGVLayer
+{
+    Q_OBJECT
+
+public:
+    QGVLayerTrails();
+
+    void setCapacity(int points);
+    int getCapacity() const;
+
+    void setMaxAge(qint64 msecs);
+    qint64 getMaxAge() const;
+
+    void setPen(const QPen& pen);
+    QPen getPen() const;
+
+    void appendPoint(int trackId, const QGV::GeoPos& geoPos, qint64 timestamp);
+    void removeTrack(int trackId);
+    void clearTracks();
+    int countTracks() const;
+    int countPoints(int trackId) const;
+
+    void expire(qint64 now);
+
+protected:
+    void onProjectionPrepare(const QGVProjection* projection) override;
+    void onProjection(QGVMap* geoMap) override;
+
+private:
+    struct Track
+    {
+        int start;
+        int size;
+        QVector<QGV::GeoPos> geoPoints;
+        QVector<QPointF> projPoints;
+        QVector<qint64> timestamps;
+    };
+
+    void projectTracks(const QGVProjection* projection);
+    int expireTrack(Track& track, qint64 now, QPolygonF& dirtyPoints) const;
+    void repaintArea(const QPolygonF& dirtyPoints);
+    QRectF projBoundingRect() const;
+    void projPaint(QPainter* painter);
+
+private:
+    QGVDrawItem* mItem;
+    int mCapacity;
+    qint64 mMaxAge;
+    QPen mPen;
+    QHash<int, Track> mTracks;
+    QVector<QLineF> mPaintLines;
+    const QGVProjection* mPreparedProjection;
+};
@@ -27,6 +27,7 @@
 
 class QGVItem;
 class QGVDrawItem;
+class QGVFrameScheduler;
 class QGVWidget;
 class QGVMapQGScene;
 class QGVMapQGView;
@@ -52,8 +53,12 @@ public:
     QGV::MouseActions getMouseActions() const;
     bool isMouseAction(QGV::MouseAction action) const;
 
+    void setWorldWrap(bool enabled);
+    bool isWorldWrap() const;
+
     QGVItem* rootItem() const;
     QGVMapQGView* geoView() const;
+    QGVFrameScheduler* frameScheduler() const;
 
     void addItem(QGVItem* item);
     void removeItem(QGVItem* item);
@@ -61,6 +66,9 @@ public:
     int countItems() const;
     QGVItem* getItem(int index) const;
 
+    void addCameraItem(QGVItem* item);
+    void removeCameraItem(QGVItem* item);
+
     void addWidget(QGVWidget* widget);
     void removeWidget(QGVWidget* widget);
     void deleteWidgets();
@@ -75,6 +83,7 @@ public:
     QList<QGVDrawItem*> search(const QPointF& projPos, Qt::ItemSelectionMode mode = Qt::ContainsItemShape) const;
     QList<QGVDrawItem*> search(const QRectF& projRect, Qt::ItemSelectionMode mode = Qt::ContainsItemShape) const;
     QList<QGVDrawItem*> search(const QPolygonF& projPolygon, Qt::ItemSelectionMode mode = Qt::ContainsItemShape) const;
+    QGVDrawItem* searchFirst(const QPointF& projPos) const;
 
     QPixmap grabMapView(bool includeWidgets = true) const;
 
@@ -109,9 +118,13 @@ Q_SIGNALS:
 
 private:
     QScopedPointer<QGVProjection> mProjection;
+    QScopedPointer<QGVFrameScheduler> mFrameScheduler;
     QScopedPointer<QGVMapQGView> mQGView;
     QScopedPointer<QGVItem> mRootItem;
     QList<QGVWidget*> mWidgets;
     QSet<QGVItem*> mSelections;
+    QSet<QGVItem*> mCameraItems;
+    QVector<QGVItem*> mCameraOrder;
+    bool mCameraOrderDirty;
     void handleDropDataOnQGVMapQGView(QPointF position, const QMimeData* dropData);
 };
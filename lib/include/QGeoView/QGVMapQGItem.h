@@ -32,6 +32,9 @@ public:
     static QGVDrawItem* geoObjectFromQGItem(QGraphicsItem* item);
 
     void resetGeometry();
+    void updateProjRect(const QRectF& projRect);
+    void setIgnoreTransformations(bool enabled, const QPointF& projAnchor);
+    bool containsProjPos(const QPointF& projPos, const QTransform& viewTransform) const;
 
 private:
     QRectF boundingRect() const override final;
@@ -42,4 +45,9 @@ private:
 
 private:
     QGVDrawItem* mGeoObject;
+    QPointF mProjOrigin;
+    mutable bool mGeometryValid;
+    mutable bool mShapeValid;
+    mutable QRectF mBoundingRect;
+    mutable QPainterPath mShape;
 };
@@ -43,6 +43,11 @@ public:
     void setMouseActions(QGV::MouseActions actions);
     QGV::MouseActions getMouseActions() const;
 
+    void setWorldWrap(bool enabled);
+    bool isWorldWrap() const;
+    QPointF wrapProjPos(const QPointF& projPos) const;
+    QList<double> wrapShifts(const QRectF& projRect) const;
+
     QGVCameraState getCamera() const;
     void cameraTo(const QGVCameraActions& actions, bool animation);
     double getMinScale() const;
@@ -60,6 +65,7 @@ private:
     void cameraScale(const QRectF& projRect);
     void cameraRotate(double azimuth);
     void cameraMove(const QPointF& projPos);
+    QPointF cameraCenter(const QPointF& projPos);
     void blockCameraUpdate();
     void unblockCameraUpdate();
     void applyCameraUpdate(const QGVCameraState& oldState);
@@ -79,6 +85,8 @@ private:
     void moveForRect(QMouseEvent* event);
     void moveMap(QMouseEvent* event);
     void moveObject(QMouseEvent* event);
+    void scheduleMove(const QPoint& pos);
+    void applyMove();
     void unselectAll(QMouseEvent* event);
     void showMenu(QMouseEvent* event);
 
@@ -95,6 +103,7 @@ private:
     void dragMoveEvent(QDragMoveEvent* event) override final;
     void dropEvent(QDropEvent* event) override final;
     void dragLeaveEvent(QDragLeaveEvent* event) override final;
+    void drawForeground(QPainter* painter, const QRectF& rect) override final;
 
 private:
     QGVMap* mGeoMap;
@@ -104,12 +113,18 @@ private:
     double mScale;
     double mAzimuth;
     QGV::MouseActions mMouseActions;
+    bool mWorldWrap;
+    double mWrapRenderShift;
     QRect mViewRect;
+    mutable QRect mCachedViewRect;
+    mutable QTransform mCachedViewTransform;
+    mutable QRectF mCachedProjRect;
     QGV::MapState mState;
     QRect mWheelMouseArea;
     QPointF mWheelProjAnchor;
     double mWheelBestFactor;
     QPointF mMoveProjAnchor;
+    QPoint mPendingMovePos;
     QGVDrawItem* mMovingObject;
     QScopedPointer<QGraphicsScene> mQGScene;
     QScopedPointer<QGVMapRubberBand> mSelectionRect;
@@ -39,6 +39,10 @@ public:
     virtual QGV::GeoRect projToGeo(QRectF const& projRect) const = 0;
     virtual double geodesicMeters(QPointF const& projPos1, QPointF const& projPos2) const = 0;
 
+    // Batch conversions may run in place, each output element may alias any input element of the same index
+    virtual void geoToProj(const double* lat, const double* lon, double* x, double* y, int count) const;
+    virtual void projToGeo(const double* x, const double* y, double* lat, double* lon, int count) const;
+
 private:
     Q_DISABLE_COPY(QGVProjection)
     QString mID;
@@ -37,6 +37,9 @@ private:
 
     double geodesicMeters(QPointF const& projPos1, QPointF const& projPos2) const override final;
 
+    void geoToProj(const double* lat, const double* lon, double* x, double* y, int count) const override final;
+    void projToGeo(const double* x, const double* y, double* lat, double* lon, int count) const override final;
+
 private:
     double mEarthRadius;
     double mOriginShift;
@@ -20,9 +20,12 @@
 
 #include <QGVGlobal.h>
 
+#include <functional>
+
 namespace QGV {
 
 QGV_LIB_DECL double metersToDistance(const double meters, const DistanceUnits unit);
 QGV_LIB_DECL QString unitToString(const DistanceUnits unit);
+QGV_LIB_DECL void parallelFor(int count, int minChunk, const std::function<void(int from, int to)>& func);
 
 } // namespace QGV
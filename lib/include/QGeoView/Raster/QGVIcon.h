@@ -26,6 +26,7 @@ class QGV_LIB_DECL QGVIcon : public QGVDrawItem
 
 public:
     QGVIcon();
+    ~QGVIcon();
 
     void setGeometry(const QGV::GeoPos& geoPos, const QSizeF& imageSize = QSizeF());
     void setGeometry(const QPointF& projPos, const QSizeF& imageSize = QSizeF());
@@ -52,4 +53,6 @@ private:
 
     QString mUrl;
     QImage mImage;
+    int mAtlasHandle;
+    QSize mAtlasPixelSize;
 };
@@ -0,0 +1,81 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include <QGeoView/QGVGlobal.h>
+
+#include <QHash>
+#include <QImage>
+#include <QPair>
+#include <QPixmap>
+#include <QVector>
+
+class QPainter;
+
+class QGV_LIB_DECL QGVIconAtlas
+{
+public:
+    static QGVIconAtlas* instance();
+
+    int acquire(const QImage& image, const QSizeF& size, qreal devicePixelRatio);
+    void release(int handle);
+    void draw(QPainter* painter, int handle, const QRectF& targetRect) const;
+    QImage image(int handle) const;
+
+    int countIcons() const;
+    int countPages() const;
+
+private:
+    QGVIconAtlas();
+    Q_DISABLE_COPY(QGVIconAtlas)
+
+    using Key = QPair<qint64, quint64>;
+
+    struct Entry
+    {
+        Key key;
+        QImage source;
+        int page;
+        QRect rect;
+        int refs;
+    };
+
+    struct Shelf
+    {
+        int top;
+        int height;
+        int cursor;
+    };
+
+    struct Page
+    {
+        QPixmap pixmap;
+        QVector<Shelf> shelves;
+        int used;
+    };
+
+    bool allocate(const QSize& pixelSize, int& page, QRect& rect);
+    void clear();
+
+private:
+    QVector<Page> mPages;
+    QVector<Entry> mEntries;
+    QHash<Key, int> mIndex;
+    QMultiHash<quint64, int> mFree;
+};
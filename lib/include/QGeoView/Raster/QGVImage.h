@@ -45,6 +45,7 @@ protected:
 
 private:
     void calculateGeometry();
+    const QImage& mipLevel(double deviceWidth);
 
 private:
     QGV::GeoRect mGeoRect;
@@ -52,5 +53,6 @@ private:
 
     QString mUrl;
     QImage mImage;
+    QVector<QImage> mMipLevels;
     bool mCeilingOnScale;
 };
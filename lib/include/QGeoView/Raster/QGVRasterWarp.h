@@ -0,0 +1,53 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include <QGeoView/QGVGlobal.h>
+
+#include <QImage>
+#include <QVector>
+
+class QGVProjection;
+
+class QGV_LIB_DECL QGVRasterWarp
+{
+public:
+    QGVRasterWarp();
+    QGVRasterWarp(const QGVProjection* source,
+                  const QGVProjection* target,
+                  const QGV::GeoRect& geoRect,
+                  const QSize& size);
+
+    QSize getSize() const;
+    bool isIdentity() const;
+
+    QImage warp(const QImage& source) const;
+
+private:
+    QVector<float> calculateLookup(const QGVProjection* source,
+                                   const QGVProjection* target,
+                                   const QGV::GeoRect& geoRect,
+                                   bool rows) const;
+
+private:
+    QSize mSize;
+    QVector<float> mColumns;
+    QVector<float> mRows;
+    bool mIdentity;
+};
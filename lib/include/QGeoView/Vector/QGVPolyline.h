@@ -0,0 +1,93 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#pragma once
+
+#include <QGeoView/QGVDrawItem.h>
+
+#include <QMap>
+#include <QPen>
+
+class QGV_LIB_DECL QGVPolyline : public QGVDrawItem
+{
+    Q_OBJECT
+
+public:
+    QGVPolyline();
+
+    void setPoints(const QVector<QGV::GeoPos>& geoPoints);
+    void setPoints(const QGV::GeoPosArray& geoPoints);
+    QVector<QGV::GeoPos> getPoints() const;
+    const QGV::GeoPosArray& getPointArray() const;
+
+    void setPen(const QPen& pen);
+    QPen getPen() const;
+
+    void setSimplification(double pixels);
+    double getSimplification() const;
+
+protected:
+    explicit QGVPolyline(bool closed);
+
+    void onProjectionPrepare(const QGVProjection* projection) override;
+    void onProjection(QGVMap* geoMap) override;
+    QPainterPath projShape() const override;
+    QRectF projBoundingRect() const override;
+    void projPaint(QPainter* painter) override;
+
+    const QPainterPath& paintPath(const QGVCameraState& camera);
+
+private:
+    struct Level
+    {
+        QVector<int> indices;
+        bool full;
+    };
+
+    struct ClipEntry
+    {
+        int band;
+        QRectF rect;
+        QPainterPath path;
+    };
+
+    void calculateGeometry();
+    void projectGeometry(const QGVProjection* projection);
+    void calculateSignificance();
+    int levelBand(double scale) const;
+    const Level& level(int band) const;
+    QPolygonF levelPoints(int band) const;
+    const QPainterPath& levelPath(int band) const;
+    QPainterPath createPath(const QPolygonF& projPoints) const;
+    QPainterPath createClippedPath(const QPolygonF& projPoints, const QRectF& clipRect) const;
+
+private:
+    const bool mClosed;
+    QGV::GeoPosArray mGeoPoints;
+    QVector<double> mProjX;
+    QVector<double> mProjY;
+    QRectF mProjRect;
+    QVector<float> mSignificance;
+    mutable QMap<int, Level> mLevels;
+    mutable int mPathBand;
+    mutable QPainterPath mPath;
+    QVector<ClipEntry> mClipCache;
+    QPen mPen;
+    double mSimplification;
+    const QGVProjection* mPreparedProjection;
+};
@@ -7,23 +7,33 @@ DEFINES += QGV_EXPORT
 
 HEADERS += \
     $$PWD/include/QGeoView/QGVCamera.h \
+    $$PWD/include/QGeoView/QGVFrameScheduler.h \
     $$PWD/include/QGeoView/QGVDrawItem.h \
+    $$PWD/include/QGeoView/QGVGeodesic.h \
     $$PWD/include/QGeoView/QGVGlobal.h \
     $$PWD/include/QGeoView/QGVUtils.h \
     $$PWD/include/QGeoView/QGVItem.h \
     $$PWD/include/QGeoView/QGVLayer.h \
     $$PWD/include/QGeoView/QGVLayerBing.h \
+    $$PWD/include/QGeoView/QGVLayerClusters.h \
     $$PWD/include/QGeoView/QGVLayerGoogle.h \
+    $$PWD/include/QGeoView/QGVLayerHeatmap.h \
+    $$PWD/include/QGeoView/QGVLayerLabels.h \
     $$PWD/include/QGeoView/QGVLayerOSM.h \
+    $$PWD/include/QGeoView/QGVLayerPlayback.h \
+    $$PWD/include/QGeoView/QGVLayerPoints.h \
+    $$PWD/include/QGeoView/QGVLayerRaster.h \
     $$PWD/include/QGeoView/QGVLayerBDGEx.h \
     $$PWD/include/QGeoView/QGVLayerTiles.h \
     $$PWD/include/QGeoView/QGVLayerTilesOnline.h \
+    $$PWD/include/QGeoView/QGVLayerTrails.h \
     $$PWD/include/QGeoView/QGVMap.h \
     $$PWD/include/QGeoView/QGVMapQGItem.h \
     $$PWD/include/QGeoView/QGVMapQGView.h \
     $$PWD/include/QGeoView/QGVMapRubberBand.h \
     $$PWD/include/QGeoView/QGVProjection.h \
     $$PWD/include/QGeoView/QGVProjectionEPSG3857.h \
+    $$PWD/include/QGeoView/QGVProjectionEPSG4326.h \
     $$PWD/include/QGeoView/QGVWidget.h \
     $$PWD/include/QGeoView/QGVWidgetCompass.h \
     $$PWD/include/QGeoView/QGVWidgetScale.h \
@@ -31,33 +41,52 @@ HEADERS += \
     $$PWD/include/QGeoView/QGVWidgetZoom.h \
     $$PWD/include/QGeoView/Raster/QGVImage.h \
     $$PWD/include/QGeoView/Raster/QGVIcon.h \
+    $$PWD/include/QGeoView/Raster/QGVIconAtlas.h \
+    $$PWD/include/QGeoView/Raster/QGVRasterWarp.h \
+    $$PWD/include/QGeoView/Vector/QGVPolyline.h \
+    $$PWD/include/QGeoView/Vector/QGVPolygon.h \
 
 SOURCES += \
     $$PWD/src/QGVCamera.cpp \
+    $$PWD/src/QGVFrameScheduler.cpp \
     $$PWD/src/QGVDrawItem.cpp \
+    $$PWD/src/QGVGeodesic.cpp \
     $$PWD/src/QGVGlobal.cpp \
     $$PWD/src/QGVUtils.cpp \
     $$PWD/src/QGVItem.cpp \
     $$PWD/src/QGVLayer.cpp \
     $$PWD/src/QGVLayerBing.cpp \
+    $$PWD/src/QGVLayerClusters.cpp \
     $$PWD/src/QGVLayerGoogle.cpp \
+    $$PWD/src/QGVLayerHeatmap.cpp \
+    $$PWD/src/QGVLayerLabels.cpp \
     $$PWD/src/QGVLayerOSM.cpp \
+    $$PWD/src/QGVLayerPlayback.cpp \
+    $$PWD/src/QGVLayerPaintItem.cpp \
+    $$PWD/src/QGVLayerPoints.cpp \
+    $$PWD/src/QGVLayerRaster.cpp \
     $$PWD/src/QGVLayerBDGEx.cpp \
     $$PWD/src/QGVLayerTiles.cpp \
     $$PWD/src/QGVLayerTilesOnline.cpp \
+    $$PWD/src/QGVLayerTrails.cpp \
     $$PWD/src/QGVMap.cpp \
     $$PWD/src/QGVMapQGItem.cpp \
     $$PWD/src/QGVMapQGView.cpp \
     $$PWD/src/QGVMapRubberBand.cpp \
     $$PWD/src/QGVProjection.cpp \
     $$PWD/src/QGVProjectionEPSG3857.cpp \
+    $$PWD/src/QGVProjectionEPSG4326.cpp \
     $$PWD/src/QGVWidget.cpp \
     $$PWD/src/QGVWidgetCompass.cpp \
     $$PWD/src/QGVWidgetScale.cpp \
     $$PWD/src/QGVWidgetText.cpp \
     $$PWD/src/QGVWidgetZoom.cpp \
     $$PWD/src/Raster/QGVImage.cpp \
-    $$PWD/src/Raster/QGVIcon.cpp
+    $$PWD/src/Raster/QGVIcon.cpp \
+    $$PWD/src/Raster/QGVIconAtlas.cpp \
+    $$PWD/src/Raster/QGVRasterWarp.cpp \
+    $$PWD/src/Vector/QGVPolyline.cpp \
+    $$PWD/src/Vector/QGVPolygon.cpp
 
 INCLUDEPATH += \
     $$PWD/include/ \
@@ -76,3 +105,7 @@ header_files.files = $$HEADERS
 header_files.path = $${DESTDIR}/include/QGeoView
 header_files.CONFIG = no_check_exist
 INSTALLS += header_files
+
+# Internal headers, not installed
+HEADERS += \
+    $$PWD/src/QGVLayerPaintItem.h
@@ -17,6 +17,7 @@
  ****************************************************************************/
 
 #include "QGVCamera.h"
+#include "QGVFrameScheduler.h"
 #include "QGVMap.h"
 
 #include <QtMath>
@@ -281,14 +282,25 @@ void QGVCameraAnimation::updateState(QAbstractAnimation::State newState, QAbstra
     }
     if (newState == QAbstractAnimation::Stopped && oldState != QAbstractAnimation::Stopped) {
         disconnect(geoMap, nullptr, this, nullptr);
+        if (geoMap->getCamera().animation()) {
+            geoMap->frameScheduler()->flush(this);
+        } else {
+            geoMap->frameScheduler()->cancel(this);
+        }
         geoMap->cameraTo(QGVCameraActions(geoMap), false);
         onStop();
     }
 }
 
-void QGVCameraAnimation::updateCurrentTime(int currentTime)
+void QGVCameraAnimation::updateCurrentTime(int /*currentTime*/)
 {
-    double progress = static_cast<double>(currentTime) / duration();
+    // Ticks between frames are coalesced, frame applies animation time it is painted at
+    mActions.origin().getMap()->frameScheduler()->schedule(this, [this]() { onFrame(); });
+}
+
+void QGVCameraAnimation::onFrame()
+{
+    double progress = static_cast<double>(currentTime()) / duration();
     if (direction() == Direction::Backward) {
         progress = 1.0 - progress;
     }
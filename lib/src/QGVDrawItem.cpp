@@ -25,7 +25,8 @@ double highlightScale = 1.15;
 }
 
 QGVDrawItem::QGVDrawItem()
-    : mDirty{ false }
+    : mCacheMode{ QGraphicsItem::DeviceCoordinateCache }
+    , mDirty{ false }
 {
 }
 
@@ -33,6 +34,11 @@ void QGVDrawItem::setFlags(QGV::ItemFlags flags)
 {
     if (mFlags != flags) {
         mFlags = flags;
+        if (isScreenSpace()) {
+            setCameraDependent(!isFlag(QGV::ItemFlag::IgnoreAzimuth));
+        } else {
+            setCameraDependent(isFlag(QGV::ItemFlag::IgnoreScale) || isFlag(QGV::ItemFlag::IgnoreAzimuth));
+        }
         projOnFlags();
         refresh();
     }
@@ -63,7 +69,7 @@ void QGVDrawItem::refresh()
     if (mQGDrawItem.isNull()) {
         return;
     }
-    if (!isVisible()) {
+    if (!isVisible() || isAutoHidden()) {
         mQGDrawItem->hide();
         return;
     }
@@ -73,8 +79,19 @@ void QGVDrawItem::refresh()
         userTransform = projTransform();
     }
     QTransform itemTransform;
-    if (isFlag(QGV::ItemFlag::Highlighted) || isFlag(QGV::ItemFlag::IgnoreScale) ||
-        isFlag(QGV::ItemFlag::IgnoreAzimuth)) {
+    const bool screenSpace = isScreenSpace();
+    if (screenSpace) {
+        double scale = 1.0;
+        double azimuth = 0.0;
+        if (isFlag(QGV::ItemFlag::Highlighted) && !isFlag(QGV::ItemFlag::HighlightCustom)) {
+            scale *= highlightScale;
+        }
+        if (!isFlag(QGV::ItemFlag::IgnoreAzimuth)) {
+            azimuth += getMap()->getCamera().azimuth();
+        }
+        itemTransform = QGV::createTransfrom(QPointF(), scale, azimuth);
+    } else if (isFlag(QGV::ItemFlag::Highlighted) || isFlag(QGV::ItemFlag::IgnoreScale) ||
+               isFlag(QGV::ItemFlag::IgnoreAzimuth)) {
         double scale = 1.0;
         double azimuth = 0.0;
         if (isFlag(QGV::ItemFlag::Highlighted) && !isFlag(QGV::ItemFlag::HighlightCustom)) {
@@ -88,6 +105,7 @@ void QGVDrawItem::refresh()
         }
         itemTransform = QGV::createTransfrom(projAnchor(), scale, azimuth);
     }
+    mQGDrawItem->setIgnoreTransformations(screenSpace, (screenSpace) ? projAnchor() : QPointF());
     mQGDrawItem->resetTransform();
     mQGDrawItem->setTransform(userTransform, true);
     mQGDrawItem->setTransform(itemTransform, true);
@@ -117,11 +135,27 @@ void QGVDrawItem::repaint()
     }
 }
 
+void QGVDrawItem::repaint(const QRectF& projRect)
+{
+    if (mQGDrawItem.isNull()) {
+        return;
+    }
+
+    if (mDirty) {
+        refresh();
+    } else {
+        mQGDrawItem->updateProjRect(projRect);
+    }
+}
+
 void QGVDrawItem::resetBoundary()
 {
     if (!mQGDrawItem.isNull()) {
         mQGDrawItem->resetGeometry();
     }
+    if (getParent() != nullptr) {
+        getParent()->onChildGeometry(this);
+    }
 
     if (isFlag(QGV::ItemFlag::Transformed) || isFlag(QGV::ItemFlag::Highlighted) ||
         isFlag(QGV::ItemFlag::IgnoreScale) || isFlag(QGV::ItemFlag::IgnoreAzimuth)) {
@@ -137,9 +171,27 @@ QTransform QGVDrawItem::effectiveTransform() const
     return mQGDrawItem->transform();
 }
 
+void QGVDrawItem::setCacheMode(QGraphicsItem::CacheMode mode)
+{
+    mCacheMode = mode;
+    if (!mQGDrawItem.isNull()) {
+        mQGDrawItem->setCacheMode(mCacheMode);
+    }
+}
+
+QGraphicsItem::CacheMode QGVDrawItem::getCacheMode() const
+{
+    return mCacheMode;
+}
+
+QRectF QGVDrawItem::projBoundingRect() const
+{
+    return projShape().boundingRect();
+}
+
 QPointF QGVDrawItem::projAnchor() const
 {
-    return projShape().boundingRect().center();
+    return projBoundingRect().center();
 }
 
 QTransform QGVDrawItem::projTransform() const
@@ -203,6 +255,7 @@ void QGVDrawItem::onProjection(QGVMap* geoMap)
     }
     if (mQGDrawItem.isNull()) {
         mQGDrawItem.reset(new QGVMapQGItem(this));
+        mQGDrawItem->setCacheMode(mCacheMode);
         geoMap->geoView()->scene()->addItem(mQGDrawItem.data());
     }
 }
@@ -210,9 +263,15 @@ void QGVDrawItem::onProjection(QGVMap* geoMap)
 void QGVDrawItem::onCamera(const QGVCameraState& oldState, const QGVCameraState& newState)
 {
     QGVItem::onCamera(oldState, newState);
-    bool neededUpdate =
-            (mFlags.testFlag(QGV::ItemFlag::IgnoreAzimuth) && !qFuzzyCompare(oldState.azimuth(), newState.azimuth())) ||
-            (mFlags.testFlag(QGV::ItemFlag::IgnoreScale) && !qFuzzyCompare(oldState.scale(), newState.scale()));
+    const bool azimuthChanged = !qFuzzyCompare(oldState.azimuth(), newState.azimuth());
+    const bool scaleChanged = !qFuzzyCompare(oldState.scale(), newState.scale());
+    bool neededUpdate = false;
+    if (isScreenSpace()) {
+        neededUpdate = !mFlags.testFlag(QGV::ItemFlag::IgnoreAzimuth) && azimuthChanged;
+    } else {
+        neededUpdate = (mFlags.testFlag(QGV::ItemFlag::IgnoreAzimuth) && azimuthChanged) ||
+                       (mFlags.testFlag(QGV::ItemFlag::IgnoreScale) && scaleChanged);
+    }
     if (!neededUpdate) {
         return;
     }
@@ -230,3 +289,8 @@ void QGVDrawItem::onClean()
     QGVItem::onClean();
     mQGDrawItem.reset(nullptr);
 }
+
+bool QGVDrawItem::isScreenSpace() const
+{
+    return isFlag(QGV::ItemFlag::IgnoreScale) && !isFlag(QGV::ItemFlag::Transformed);
+}
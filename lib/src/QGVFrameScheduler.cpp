@@ -0,0 +1,109 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "QGVFrameScheduler.h"
+
+QGVFrameScheduler::QGVFrameScheduler(QObject* parent)
+    : QObject(parent)
+    , mFrameBudget(12)
+{
+    mTimer.setTimerType(Qt::PreciseTimer);
+    mTimer.setInterval(16);
+    connect(&mTimer, &QTimer::timeout, this, &QGVFrameScheduler::onFrame);
+}
+
+void QGVFrameScheduler::setFrameInterval(int msecs)
+{
+    mTimer.setInterval(qMax(1, msecs));
+}
+
+int QGVFrameScheduler::getFrameInterval() const
+{
+    return mTimer.interval();
+}
+
+void QGVFrameScheduler::setFrameBudget(int msecs)
+{
+    mFrameBudget = qMax(1, msecs);
+}
+
+int QGVFrameScheduler::getFrameBudget() const
+{
+    return mFrameBudget;
+}
+
+void QGVFrameScheduler::schedule(QObject* owner, const std::function<void()>& task)
+{
+    Q_ASSERT(owner);
+    // Same owner keeps one pending task, latest state wins
+    if (!mTasks.contains(owner)) {
+        mOrder.append(owner);
+    }
+    mTasks[owner] = Task{ owner, task };
+    if (!mTimer.isActive()) {
+        mTimer.start();
+    }
+}
+
+void QGVFrameScheduler::cancel(QObject* owner)
+{
+    if (mTasks.remove(owner) > 0) {
+        mOrder.removeOne(owner);
+    }
+}
+
+void QGVFrameScheduler::flush(QObject* owner)
+{
+    if (!mTasks.contains(owner)) {
+        return;
+    }
+    const Task task = mTasks.take(owner);
+    mOrder.removeOne(owner);
+    if (!task.owner.isNull()) {
+        task.func();
+    }
+}
+
+bool QGVFrameScheduler::isScheduled(QObject* owner) const
+{
+    return mTasks.contains(owner);
+}
+
+void QGVFrameScheduler::onFrame()
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    // Tasks scheduled during this frame are left for the next one
+    const int count = mOrder.size();
+    for (int i = 0; i < count && !mOrder.isEmpty(); ++i) {
+        if (i > 0 && elapsed.elapsed() >= mFrameBudget) {
+            qgvDebug() << "frame budget exceeded, tasks left" << mOrder.size();
+            break;
+        }
+        QObject* owner = mOrder.takeFirst();
+        const Task task = mTasks.take(owner);
+        if (!task.owner.isNull()) {
+            task.func();
+        }
+    }
+
+    if (mOrder.isEmpty()) {
+        mTimer.stop();
+    }
+}
@@ -0,0 +1,406 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "QGVGeodesic.h"
+#include "QGVUtils.h"
+
+#include <QMutex>
+#include <QtMath>
+
+#include <cmath>
+#include <limits>
+
+namespace {
+const double sphereRadius = 6378137.0; /* meters, same sphere as EPSG3857 */
+const double wgs84A = 6378137.0;
+const double wgs84F = 1.0 / 298.257223563;
+const double wgs84B = (1.0 - wgs84F) * wgs84A;
+const double degToRad = M_PI / 180.0;
+const double radToDeg = 180.0 / M_PI;
+const int vincentyIterations = 100;
+const double vincentyEpsilon = 1e-12;
+const int parallelMinCount = 16 * 1024;
+const int parallelChunk = 4 * 1024;
+
+struct ReducedLat
+{
+    double sinU;
+    double cosU;
+};
+
+ReducedLat reducedLat(double latRad)
+{
+    const double tanU = (1.0 - wgs84F) * std::tan(latRad);
+    const double cosU = 1.0 / std::sqrt(1.0 + tanU * tanU);
+    return { tanU * cosU, cosU };
+}
+
+struct Origin
+{
+    double lat;
+    double lon;
+    double sinLat;
+    double cosLat;
+    ReducedLat reduced;
+};
+
+Origin makeOrigin(const QGV::GeoPos& geoPos)
+{
+    const double lat = geoPos.latitude() * degToRad;
+    const double lon = geoPos.longitude() * degToRad;
+    return { lat, lon, std::sin(lat), std::cos(lat), reducedLat(lat) };
+}
+
+// All batch functions share one threshold, small inputs stay on calling thread
+void batchFor(int count, const std::function<void(int from, int to)>& func)
+{
+    if (count >= parallelMinCount) {
+        QGV::parallelFor(count, parallelChunk, func);
+    } else if (count > 0) {
+        func(0, count);
+    }
+}
+
+double vincentyCoefficient(double cosSqAlpha, double* bCoef)
+{
+    const double uSq = cosSqAlpha * (wgs84A * wgs84A - wgs84B * wgs84B) / (wgs84B * wgs84B);
+    *bCoef = uSq / 1024.0 * (256.0 + uSq * (-128.0 + uSq * (74.0 - 47.0 * uSq)));
+    return 1.0 + uSq / 16384.0 * (4096.0 + uSq * (-768.0 + uSq * (320.0 - 175.0 * uSq)));
+}
+
+double vincentyDeltaSigma(double bCoef, double sinSigma, double cosSigma, double cos2SigmaM)
+{
+    const double cos2SigmaMSq = cos2SigmaM * cos2SigmaM;
+    return bCoef * sinSigma *
+           (cos2SigmaM + bCoef / 4.0 *
+                                 (cosSigma * (-1.0 + 2.0 * cos2SigmaMSq) -
+                                  bCoef / 6.0 * cos2SigmaM * (-3.0 + 4.0 * sinSigma * sinSigma) *
+                                          (-3.0 + 4.0 * cos2SigmaMSq)));
+}
+
+// Inverse problem, returns NaN when iteration does not converge (nearly antipodal points)
+double vincentyInverse(ReducedLat first, ReducedLat second, double lonDelta)
+{
+    double lambda = lonDelta;
+    for (int iteration = 0; iteration < vincentyIterations; ++iteration) {
+        const double sinLambda = std::sin(lambda);
+        const double cosLambda = std::cos(lambda);
+        const double crossA = second.cosU * sinLambda;
+        const double crossB = first.cosU * second.sinU - first.sinU * second.cosU * cosLambda;
+        const double sinSigma = std::sqrt(crossA * crossA + crossB * crossB);
+        if (sinSigma == 0.0) {
+            return 0.0;
+        }
+        const double cosSigma = first.sinU * second.sinU + first.cosU * second.cosU * cosLambda;
+        const double sigma = std::atan2(sinSigma, cosSigma);
+        const double sinAlpha = first.cosU * second.cosU * sinLambda / sinSigma;
+        const double cosSqAlpha = 1.0 - sinAlpha * sinAlpha;
+        const double cos2SigmaM =
+                (cosSqAlpha != 0.0) ? cosSigma - 2.0 * first.sinU * second.sinU / cosSqAlpha : 0.0;
+        const double c = wgs84F / 16.0 * cosSqAlpha * (4.0 + wgs84F * (4.0 - 3.0 * cosSqAlpha));
+        const double lambdaPrev = lambda;
+        lambda = lonDelta + (1.0 - c) * wgs84F * sinAlpha *
+                                    (sigma + c * sinSigma *
+                                                     (cos2SigmaM + c * cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM)));
+        if (std::abs(lambda - lambdaPrev) < vincentyEpsilon) {
+            double bCoef = 0;
+            const double aCoef = vincentyCoefficient(cosSqAlpha, &bCoef);
+            return wgs84B * aCoef * (sigma - vincentyDeltaSigma(bCoef, sinSigma, cosSigma, cos2SigmaM));
+        }
+    }
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+double haversineDistance(double lat1, double lon1, double lat2, double lon2)
+{
+    const double latSin = std::sin((lat2 - lat1) * 0.5);
+    const double lonSin = std::sin((lon2 - lon1) * 0.5);
+    const double h = latSin * latSin + std::cos(lat1) * std::cos(lat2) * lonSin * lonSin;
+    return 2.0 * sphereRadius * std::asin(std::sqrt(qMin(1.0, h)));
+}
+
+QGV::GeoPos sphereDestination(const Origin& origin, double bearing, double meters)
+{
+    const double delta = meters / sphereRadius;
+    const double sinLat = origin.sinLat;
+    const double cosLat = origin.cosLat;
+    const double sinDelta = std::sin(delta);
+    const double cosDelta = std::cos(delta);
+    const double sinLat2 = sinLat * cosDelta + cosLat * sinDelta * std::cos(bearing);
+    const double lat2 = std::asin(sinLat2);
+    const double lon2 = origin.lon + std::atan2(std::sin(bearing) * sinDelta * cosLat, cosDelta - sinLat * sinLat2);
+    return QGV::GeoPos(lat2 * radToDeg, std::remainder(lon2 * radToDeg, 360.0));
+}
+
+QGV::GeoPos vincentyDestination(const Origin& origin, double bearing, double meters)
+{
+    const ReducedLat first = origin.reduced;
+    const double sinAlpha1 = std::sin(bearing);
+    const double cosAlpha1 = std::cos(bearing);
+    const double sigma1 = std::atan2(first.sinU / first.cosU, cosAlpha1);
+    const double sinAlpha = first.cosU * sinAlpha1;
+    const double cosSqAlpha = 1.0 - sinAlpha * sinAlpha;
+    double bCoef = 0;
+    const double aCoef = vincentyCoefficient(cosSqAlpha, &bCoef);
+
+    double sigma = meters / (wgs84B * aCoef);
+    double sinSigma = std::sin(sigma);
+    double cosSigma = std::cos(sigma);
+    double cos2SigmaM = std::cos(2.0 * sigma1 + sigma);
+    for (int iteration = 0; iteration < vincentyIterations; ++iteration) {
+        cos2SigmaM = std::cos(2.0 * sigma1 + sigma);
+        sinSigma = std::sin(sigma);
+        cosSigma = std::cos(sigma);
+        const double sigmaPrev = sigma;
+        sigma = meters / (wgs84B * aCoef) + vincentyDeltaSigma(bCoef, sinSigma, cosSigma, cos2SigmaM);
+        if (std::abs(sigma - sigmaPrev) < vincentyEpsilon) {
+            break;
+        }
+    }
+    sinSigma = std::sin(sigma);
+    cosSigma = std::cos(sigma);
+    cos2SigmaM = std::cos(2.0 * sigma1 + sigma);
+
+    const double tmp = first.sinU * sinSigma - first.cosU * cosSigma * cosAlpha1;
+    const double lat2 = std::atan2(first.sinU * cosSigma + first.cosU * sinSigma * cosAlpha1,
+                                   (1.0 - wgs84F) * std::sqrt(sinAlpha * sinAlpha + tmp * tmp));
+    const double lambda = std::atan2(sinSigma * sinAlpha1, first.cosU * cosSigma - first.sinU * sinSigma * cosAlpha1);
+    const double c = wgs84F / 16.0 * cosSqAlpha * (4.0 + wgs84F * (4.0 - 3.0 * cosSqAlpha));
+    const double lonDelta =
+            lambda - (1.0 - c) * wgs84F * sinAlpha *
+                             (sigma + c * sinSigma * (cos2SigmaM + c * cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM)));
+    return QGV::GeoPos(lat2 * radToDeg, std::remainder((origin.lon + lonDelta) * radToDeg, 360.0));
+}
+}
+
+namespace QGV {
+
+double geodesicDistance(const GeoPos& from, const GeoPos& to, GeodesicMethod method)
+{
+    const double lat1 = from.latitude() * degToRad;
+    const double lon1 = from.longitude() * degToRad;
+    const double lat2 = to.latitude() * degToRad;
+    const double lon2 = to.longitude() * degToRad;
+    if (method == GeodesicMethod::Vincenty) {
+        const double meters = vincentyInverse(reducedLat(lat1), reducedLat(lat2), lon2 - lon1);
+        if (!std::isnan(meters)) {
+            return meters;
+        }
+    }
+    return haversineDistance(lat1, lon1, lat2, lon2);
+}
+
+double geodesicBearing(const GeoPos& from, const GeoPos& to)
+{
+    const double lat1 = from.latitude() * degToRad;
+    const double lat2 = to.latitude() * degToRad;
+    const double lonDelta = (to.longitude() - from.longitude()) * degToRad;
+    const double y = std::sin(lonDelta) * std::cos(lat2);
+    const double x = std::cos(lat1) * std::sin(lat2) - std::sin(lat1) * std::cos(lat2) * std::cos(lonDelta);
+    const double bearing = std::atan2(y, x) * radToDeg;
+    return (bearing < 0) ? bearing + 360.0 : bearing;
+}
+
+GeoPos geodesicDestination(const GeoPos& from, double bearing, double meters, GeodesicMethod method)
+{
+    const Origin origin = makeOrigin(from);
+    if (method == GeodesicMethod::Vincenty) {
+        return vincentyDestination(origin, bearing * degToRad, meters);
+    }
+    return sphereDestination(origin, bearing * degToRad, meters);
+}
+
+void geodesicDestinations(const GeoPos& from,
+                          const double* bearings,
+                          const double* meters,
+                          double* lat,
+                          double* lon,
+                          int count,
+                          GeodesicMethod method)
+{
+    const Origin origin = makeOrigin(from);
+    batchFor(count, [&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            const double bearing = bearings[i] * degToRad;
+            const GeoPos geoPos = (method == GeodesicMethod::Vincenty)
+                                          ? vincentyDestination(origin, bearing, meters[i])
+                                          : sphereDestination(origin, bearing, meters[i]);
+            lat[i] = geoPos.latitude();
+            lon[i] = geoPos.longitude();
+        }
+    });
+}
+
+} // namespace QGV
+
+QGVGeodesicPoints::QGVGeodesicPoints()
+{
+}
+
+QGVGeodesicPoints::QGVGeodesicPoints(const double* lat, const double* lon, int count)
+{
+    setPoints(lat, lon, count);
+}
+
+void QGVGeodesicPoints::setPoints(const double* lat, const double* lon, int count)
+{
+    Q_ASSERT(count >= 0);
+    Q_ASSERT(count == 0 || (lat != nullptr && lon != nullptr));
+    mLatRad.resize(count);
+    mLonRad.resize(count);
+    mSinLat.resize(count);
+    mCosLat.resize(count);
+    mSinLon.resize(count);
+    mCosLon.resize(count);
+    mSinU.resize(count);
+    mCosU.resize(count);
+    for (int i = 0; i < count; ++i) {
+        mLatRad[i] = lat[i] * degToRad;
+        mLonRad[i] = lon[i] * degToRad;
+        mSinLat[i] = std::sin(mLatRad[i]);
+        mCosLat[i] = std::cos(mLatRad[i]);
+        mSinLon[i] = std::sin(mLonRad[i]);
+        mCosLon[i] = std::cos(mLonRad[i]);
+        const ReducedLat reduced = reducedLat(mLatRad[i]);
+        mSinU[i] = reduced.sinU;
+        mCosU[i] = reduced.cosU;
+    }
+}
+
+int QGVGeodesicPoints::countPoints() const
+{
+    return mLatRad.size();
+}
+
+void QGVGeodesicPoints::distances(const QGV::GeoPos& origin, double* meters, QGV::GeodesicMethod method) const
+{
+    if (method == QGV::GeodesicMethod::Vincenty) {
+        batchFor(countPoints(), [&](int from, int to) { vincenty(origin, meters, from, to); });
+    } else {
+        batchFor(countPoints(), [&](int from, int to) { haversine(origin, meters, from, to); });
+    }
+}
+
+void QGVGeodesicPoints::bearings(const QGV::GeoPos& origin, double* degrees) const
+{
+    const double lat = origin.latitude() * degToRad;
+    const double sinLat = std::sin(lat);
+    const double cosLat = std::cos(lat);
+    const double sinLon = std::sin(origin.longitude() * degToRad);
+    const double cosLon = std::cos(origin.longitude() * degToRad);
+    batchFor(countPoints(), [&](int from, int to) {
+        for (int i = from; i < to; ++i) {
+            const double sinDelta = mSinLon[i] * cosLon - mCosLon[i] * sinLon;
+            const double cosDelta = mCosLon[i] * cosLon + mSinLon[i] * sinLon;
+            const double y = sinDelta * mCosLat[i];
+            const double x = cosLat * mSinLat[i] - sinLat * mCosLat[i] * cosDelta;
+            const double bearing = std::atan2(y, x) * radToDeg;
+            degrees[i] = (bearing < 0) ? bearing + 360.0 : bearing;
+        }
+    });
+}
+
+QVector<int> QGVGeodesicPoints::within(const QGV::GeoPos& origin, double meters) const
+{
+    // Compared as squared chord of unit sphere, no inverse trig per point
+    const double halfAngle = qMin(M_PI_2, meters / sphereRadius * 0.5);
+    const double chordSqLimit = 4.0 * std::sin(halfAngle) * std::sin(halfAngle);
+    const double lat = origin.latitude() * degToRad;
+    const double lon = origin.longitude() * degToRad;
+    const double originX = std::cos(lat) * std::cos(lon);
+    const double originY = std::cos(lat) * std::sin(lon);
+    const double originZ = std::sin(lat);
+    const int count = countPoints();
+    QVector<char> inside(count, 0);
+    batchFor(count, [&](int from, int to) {
+        for (int i = from; i < to; ++i) {
+            const double dx = mCosLat[i] * mCosLon[i] - originX;
+            const double dy = mCosLat[i] * mSinLon[i] - originY;
+            const double dz = mSinLat[i] - originZ;
+            inside[i] = (dx * dx + dy * dy + dz * dz <= chordSqLimit) ? 1 : 0;
+        }
+    });
+    QVector<int> result;
+    for (int i = 0; i < count; ++i) {
+        if (inside[i] != 0) {
+            result.append(i);
+        }
+    }
+    return result;
+}
+
+int QGVGeodesicPoints::nearest(const QGV::GeoPos& origin) const
+{
+    const double lat = origin.latitude() * degToRad;
+    const double lon = origin.longitude() * degToRad;
+    const double originX = std::cos(lat) * std::cos(lon);
+    const double originY = std::cos(lat) * std::sin(lon);
+    const double originZ = std::sin(lat);
+    int best = -1;
+    double bestChordSq = std::numeric_limits<double>::max();
+    QMutex mutex;
+    batchFor(countPoints(), [&](int from, int to) {
+        int chunkBest = -1;
+        double chunkChordSq = std::numeric_limits<double>::max();
+        for (int i = from; i < to; ++i) {
+            const double dx = mCosLat[i] * mCosLon[i] - originX;
+            const double dy = mCosLat[i] * mSinLon[i] - originY;
+            const double dz = mSinLat[i] - originZ;
+            const double chordSq = dx * dx + dy * dy + dz * dz;
+            if (chordSq < chunkChordSq) {
+                chunkChordSq = chordSq;
+                chunkBest = i;
+            }
+        }
+        // Ties resolve to lowest index, same as serial scan
+        QMutexLocker locker(&mutex);
+        if (chunkBest >= 0 && (chunkChordSq < bestChordSq || (chunkChordSq == bestChordSq && chunkBest < best))) {
+            bestChordSq = chunkChordSq;
+            best = chunkBest;
+        }
+    });
+    return best;
+}
+
+void QGVGeodesicPoints::haversine(const QGV::GeoPos& origin, double* meters, int from, int to) const
+{
+    // Chord length on unit sphere keeps precision for short distances
+    const double lat = origin.latitude() * degToRad;
+    const double lon = origin.longitude() * degToRad;
+    const double originX = std::cos(lat) * std::cos(lon);
+    const double originY = std::cos(lat) * std::sin(lon);
+    const double originZ = std::sin(lat);
+    for (int i = from; i < to; ++i) {
+        const double dx = mCosLat[i] * mCosLon[i] - originX;
+        const double dy = mCosLat[i] * mSinLon[i] - originY;
+        const double dz = mSinLat[i] - originZ;
+        const double halfChord = 0.5 * std::sqrt(dx * dx + dy * dy + dz * dz);
+        meters[i] = 2.0 * sphereRadius * std::asin(qMin(1.0, halfChord));
+    }
+}
+
+void QGVGeodesicPoints::vincenty(const QGV::GeoPos& origin, double* meters, int from, int to) const
+{
+    const Origin first = makeOrigin(origin);
+    const double lat = first.lat;
+    const double lon = first.lon;
+    for (int i = from; i < to; ++i) {
+        const double distance = vincentyInverse(first.reduced, { mSinU[i], mCosU[i] }, mLonRad[i] - lon);
+        meters[i] = (std::isnan(distance)) ? haversineDistance(lat, lon, mLatRad[i], mLonRad[i]) : distance;
+    }
+}
@@ -18,12 +18,55 @@
 
 #include "QGVGlobal.h"
 #include "QGVMap.h"
+#include "QGVProjection.h"
 
 #include <QTransform>
 #include <QtGlobal>
 #include <QtMath>
 
+#include <cmath>
+
 namespace {
+const int tileEdgeTableMaxZoom = 14;
+const int mortonBits = 29;
+
+// Latitudes of tile edges for low zooms, offset of zoom z is 2^z - 1 + z
+const QVector<double>& tileEdgeTable()
+{
+    static const QVector<double> table = []() {
+        QVector<double> result;
+        for (int zoom = 0; zoom <= tileEdgeTableMaxZoom; ++zoom) {
+            const int count = 1 << zoom;
+            for (int y = 0; y <= count; ++y) {
+                const double n = M_PI - 2.0 * M_PI * std::ldexp(y, -zoom);
+                result.append(180.0 / M_PI * std::atan(std::sinh(n)));
+            }
+        }
+        return result;
+    }();
+    return table;
+}
+
+double tileEdgeLatitude(int zoom, int y)
+{
+    if (zoom >= 0 && zoom <= tileEdgeTableMaxZoom && y >= 0 && y <= (1 << zoom)) {
+        return tileEdgeTable().at((1 << zoom) - 1 + zoom + y);
+    }
+    const double n = M_PI - 2.0 * M_PI * std::ldexp(y, -zoom);
+    return 180.0 / M_PI * std::atan(std::sinh(n));
+}
+
+quint64 spreadBits(quint32 value)
+{
+    quint64 result = value & ((1u << mortonBits) - 1);
+    result = (result | (result << 16)) & 0x0000FFFF0000FFFFull;
+    result = (result | (result << 8)) & 0x00FF00FF00FF00FFull;
+    result = (result | (result << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    result = (result | (result << 2)) & 0x3333333333333333ull;
+    result = (result | (result << 1)) & 0x5555555555555555ull;
+    return result;
+}
+
 bool drawDebugEnabled = false;
 bool printDebugEnabled = false;
 QNetworkAccessManager* networkManager = nullptr;
@@ -290,6 +333,16 @@ bool GeoTilePos::operator<(const GeoTilePos& other) const
     return mPos.y() < other.mPos.y();
 }
 
+bool GeoTilePos::operator==(const GeoTilePos& other) const
+{
+    return mZoom == other.mZoom && mPos == other.mPos;
+}
+
+bool GeoTilePos::operator!=(const GeoTilePos& other) const
+{
+    return !(*this == other);
+}
+
 int GeoTilePos::zoom() const
 {
     return mZoom;
@@ -300,13 +353,20 @@ QPoint GeoTilePos::pos() const
     return mPos;
 }
 
+quint64 GeoTilePos::mortonKey() const
+{
+    // Zoom in top bits, interleaved 29 bits of x and y below
+    const quint64 zoomBits = static_cast<quint64>(mZoom & 0x3f) << (2 * mortonBits);
+    return zoomBits | spreadBits(static_cast<quint32>(mPos.x())) | (spreadBits(static_cast<quint32>(mPos.y())) << 1);
+}
+
 bool GeoTilePos::contains(const GeoTilePos& other) const
 {
-    if (zoom() >= other.zoom()) {
+    const int deltaZoom = other.zoom() - zoom();
+    if (deltaZoom <= 0) {
         return false;
     }
-    GeoTilePos parentTile = other.parent(zoom());
-    return (pos().x() == parentTile.pos().x() && pos().y() == parentTile.pos().y());
+    return (other.pos().x() >> deltaZoom) == pos().x() && (other.pos().y() >> deltaZoom) == pos().y();
 }
 
 GeoTilePos GeoTilePos::parent(int parentZoom) const
@@ -315,26 +375,26 @@ GeoTilePos GeoTilePos::parent(int parentZoom) const
         return GeoTilePos();
     }
     const int deltaZoom = zoom() - parentZoom;
-    const int factor = static_cast<int>(qPow(2, deltaZoom));
-    const int x = static_cast<int>(qFloor(pos().x() / factor));
-    const int y = static_cast<int>(qFloor(pos().y() / factor));
-    return GeoTilePos(parentZoom, QPoint(x, y));
+    return GeoTilePos(parentZoom, QPoint(pos().x() >> deltaZoom, pos().y() >> deltaZoom));
+}
+
+QRect GeoTilePos::childRect(int childZoom) const
+{
+    if (childZoom < zoom()) {
+        return QRect();
+    }
+    const int deltaZoom = childZoom - zoom();
+    const int size = 1 << deltaZoom;
+    return QRect(QPoint(pos().x() << deltaZoom, pos().y() << deltaZoom), QSize(size, size));
 }
 
 GeoRect GeoTilePos::toGeoRect() const
 {
-    const auto leftTop = [](const GeoTilePos& tilePos) -> GeoPos {
-        const int zoom = tilePos.zoom();
-        const int x = tilePos.pos().x();
-        const int y = tilePos.pos().y();
-        const double lon = x / pow(2.0, zoom) * 360.0 - 180;
-        const double n = M_PI - 2.0 * M_PI * y / pow(2.0, zoom);
-        const double lat = 180.0 / M_PI * atan(0.5 * (exp(n) - exp(-n)));
-        return GeoPos(lat, lon);
-    };
-    const GeoPos pos1 = leftTop(*this);
-    const GeoPos pos2 = leftTop(GeoTilePos(mZoom, mPos + QPoint(1, 1)));
-    return GeoRect(pos1, pos2);
+    const double lonLeft = std::ldexp(mPos.x(), -mZoom) * 360.0 - 180.0;
+    const double lonRight = std::ldexp(mPos.x() + 1, -mZoom) * 360.0 - 180.0;
+    const double latTop = tileEdgeLatitude(mZoom, mPos.y());
+    const double latBottom = tileEdgeLatitude(mZoom, mPos.y() + 1);
+    return GeoRect(GeoPos(latTop, lonLeft), GeoPos(latBottom, lonRight));
 }
 
 QString GeoTilePos::toQuadKey() const
@@ -359,14 +419,149 @@ QString GeoTilePos::toQuadKey() const
 
 GeoTilePos GeoTilePos::geoToTilePos(int zoom, const GeoPos& geoPos)
 {
+    const double mercatorLatLimit = 85.0511287798;
     const double lon = geoPos.longitude();
-    const double lat = geoPos.latitude();
-    const double x = floor((lon + 180.0) / 360.0 * pow(2.0, zoom));
-    const double y =
-            floor((1.0 - log(tan(lat * M_PI / 180.0) + 1.0 / cos(lat * M_PI / 180.0)) / M_PI) / 2.0 * pow(2.0, zoom));
+    const double lat = qBound(-mercatorLatLimit, geoPos.latitude(), mercatorLatLimit);
+    const double tiles = std::ldexp(1.0, zoom);
+    const double x = floor((lon + 180.0) / 360.0 * tiles);
+    const double y = floor((1.0 - std::asinh(std::tan(lat * M_PI / 180.0)) / M_PI) / 2.0 * tiles);
     return GeoTilePos(zoom, QPoint(static_cast<int>(x), static_cast<int>(y)));
 }
 
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+size_t qHash(const GeoTilePos& key, size_t seed)
+#else
+uint qHash(const GeoTilePos& key, uint seed)
+#endif
+{
+    return qHash(key.mortonKey(), seed);
+}
+
+constexpr double GeoPosArray::unitsPerDegree;
+
+GeoPosArray::GeoPosArray()
+{
+}
+
+GeoPosArray::GeoPosArray(const QVector<GeoPos>& geoPoints)
+{
+    reserve(geoPoints.size());
+    for (const GeoPos& geoPos : geoPoints) {
+        append(geoPos);
+    }
+}
+
+int GeoPosArray::size() const
+{
+    return mLat.size();
+}
+
+bool GeoPosArray::isEmpty() const
+{
+    return mLat.isEmpty();
+}
+
+void GeoPosArray::reserve(int size)
+{
+    mLat.reserve(size);
+    mLon.reserve(size);
+}
+
+void GeoPosArray::clear()
+{
+    mLat.clear();
+    mLon.clear();
+}
+
+void GeoPosArray::append(double lat, double lon)
+{
+    // Longitude is wrapped only when it is out of range, latitude is clamped
+    if (lon > 180.0 || lon < -180.0) {
+        lon = std::remainder(lon, 360.0);
+    }
+    mLat.append(toUnits(qBound(-90.0, lat, 90.0)));
+    mLon.append(toUnits(lon));
+}
+
+void GeoPosArray::append(const GeoPos& geoPos)
+{
+    mLat.append(toUnits(geoPos.latitude()));
+    mLon.append(toUnits(geoPos.longitude()));
+}
+
+void GeoPosArray::set(int index, double lat, double lon)
+{
+    if (lon > 180.0 || lon < -180.0) {
+        lon = std::remainder(lon, 360.0);
+    }
+    mLat[index] = toUnits(qBound(-90.0, lat, 90.0));
+    mLon[index] = toUnits(lon);
+}
+
+GeoPos GeoPosArray::at(int index) const
+{
+    return GeoPos(latitude(index), longitude(index));
+}
+
+double GeoPosArray::latitude(int index) const
+{
+    return mLat.at(index) / unitsPerDegree;
+}
+
+double GeoPosArray::longitude(int index) const
+{
+    return mLon.at(index) / unitsPerDegree;
+}
+
+const qint32* GeoPosArray::latitudeData() const
+{
+    return mLat.constData();
+}
+
+const qint32* GeoPosArray::longitudeData() const
+{
+    return mLon.constData();
+}
+
+void GeoPosArray::toDegrees(int from, int count, double* lat, double* lon) const
+{
+    const qint32* latUnits = mLat.constData() + from;
+    const qint32* lonUnits = mLon.constData() + from;
+    for (int i = 0; i < count; ++i) {
+        lat[i] = latUnits[i] / unitsPerDegree;
+        lon[i] = lonUnits[i] / unitsPerDegree;
+    }
+}
+
+void GeoPosArray::toProj(const QGVProjection* projection, double* x, double* y) const
+{
+    // Degrees are expanded straight into output arrays and projected in place, no temporary buffers
+    toDegrees(0, size(), y, x);
+    projection->geoToProj(y, x, x, y, size());
+}
+
+QVector<GeoPos> GeoPosArray::toVector() const
+{
+    QVector<GeoPos> result;
+    result.reserve(size());
+    for (int i = 0; i < size(); ++i) {
+        result.append(at(i));
+    }
+    return result;
+}
+
+qint32 GeoPosArray::toUnits(double degrees)
+{
+    return static_cast<qint32>(std::lround(degrees * unitsPerDegree));
+}
+
+int scaleToZoom(double scale)
+{
+    // Tile zoom level of web tiles shown at camera scale
+    const double scaleChange = 1 / scale;
+    return qRound((17.0 - qLn(scaleChange) * M_LOG2E));
+}
+
 QTransform createTransfrom(const QPointF& projAnchor, double scale, double azimuth)
 {
     const bool scaleChanged = !qFuzzyCompare(scale, 1.0);
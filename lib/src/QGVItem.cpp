@@ -17,6 +17,8 @@
  ****************************************************************************/
 
 #include "QGVItem.h"
+#include "QGVUtils.h"
+
 #include <limits>
 
 QGVItem::QGVItem(QGVItem* parent)
@@ -25,15 +27,24 @@ QGVItem::QGVItem(QGVItem* parent)
     mZValue = 0;
     mOpacity = 1.0;
     mVisible = true;
+    mAutoHidden = false;
     mSelectable = false;
     mSelected = false;
+    mCameraDependent = false;
 }
 
 QGVItem::~QGVItem()
 {
     deleteItems();
+    if (mCameraDependent) {
+        auto geoMap = getMap();
+        if (geoMap != nullptr) {
+            geoMap->removeCameraItem(this);
+        }
+    }
     if (mParent != nullptr) {
         mParent->mChildrens.removeAll(this);
+        mParent->onChildRemoved(this);
     }
 }
 
@@ -43,6 +54,7 @@ void QGVItem::setParent(QGVItem* item)
         return;
     }
     setSelected(false);
+    auto oldMap = getMap();
     if (mParent != nullptr) {
         mParent->mChildrens.removeAll(this);
     }
@@ -52,6 +64,9 @@ void QGVItem::setParent(QGVItem* item)
         mParent->mChildrens.append(this);
     }
     auto geoMap = getMap();
+    if (oldMap != geoMap) {
+        updateCameraItems(oldMap, geoMap);
+    }
     if (geoMap != nullptr) {
         if (oldParent != nullptr) {
             Q_EMIT geoMap->itemsChanged(oldParent);
@@ -59,11 +74,17 @@ void QGVItem::setParent(QGVItem* item)
         if (mParent != nullptr) {
             Q_EMIT geoMap->itemsChanged(mParent);
         }
-        onProjection(geoMap);
+        applyProjection(geoMap);
         update();
     } else {
         onClean();
     }
+    if (oldParent != nullptr) {
+        oldParent->onChildRemoved(this);
+    }
+    if (mParent != nullptr) {
+        mParent->onChildAdded(this);
+    }
 }
 
 QGVItem* QGVItem::getParent() const
@@ -224,6 +245,43 @@ void QGVItem::hide()
     setVisible(false);
 }
 
+void QGVItem::setAutoHidden(bool hidden)
+{
+    // Hidden by owning layer (e.g. clustering), user visibility stays untouched
+    if (mAutoHidden == hidden) {
+        return;
+    }
+    mAutoHidden = hidden;
+    update();
+}
+
+bool QGVItem::isAutoHidden() const
+{
+    return mAutoHidden;
+}
+
+void QGVItem::setCameraDependent(bool dependent)
+{
+    if (mCameraDependent == dependent) {
+        return;
+    }
+    mCameraDependent = dependent;
+    auto geoMap = getMap();
+    if (geoMap == nullptr) {
+        return;
+    }
+    if (mCameraDependent) {
+        geoMap->addCameraItem(this);
+    } else {
+        geoMap->removeCameraItem(this);
+    }
+}
+
+bool QGVItem::isCameraDependent() const
+{
+    return mCameraDependent;
+}
+
 double QGVItem::effectiveZValue() const
 {
     if (mParent == nullptr) {
@@ -249,9 +307,9 @@ double QGVItem::effectiveOpacity() const
 bool QGVItem::effectivelyVisible() const
 {
     if (mParent == nullptr) {
-        return mVisible;
+        return mVisible && !mAutoHidden;
     }
-    return mVisible && mParent->effectivelyVisible();
+    return mVisible && !mAutoHidden && mParent->effectivelyVisible();
 }
 
 void QGVItem::update()
@@ -265,6 +323,24 @@ void QGVItem::update()
     onUpdate();
 }
 
+void QGVItem::applyProjection(QGVMap* geoMap)
+{
+    // Geometry of whole subtree is prepared in parallel, scene is updated after on GUI thread
+    QVector<QGVItem*> items;
+    collectItems(items);
+    const QGVProjection* projection = geoMap->getProjection();
+    QGV::parallelFor(items.size(), 1, [&items, projection](int from, int to) {
+        for (int i = from; i < to; ++i) {
+            items[i]->onProjectionPrepare(projection);
+        }
+    });
+    onProjection(geoMap);
+}
+
+void QGVItem::onProjectionPrepare(const QGVProjection* /*projection*/)
+{
+}
+
 void QGVItem::onProjection(QGVMap* geoMap)
 {
     for (QGVItem* obj : mChildrens) {
@@ -272,22 +348,52 @@ void QGVItem::onProjection(QGVMap* geoMap)
     }
 }
 
-void QGVItem::onCamera(const QGVCameraState& oldState, const QGVCameraState& newState)
+void QGVItem::onCamera(const QGVCameraState& /*oldState*/, const QGVCameraState& /*newState*/)
 {
-    for (QGVItem* obj : mChildrens) {
-        if (obj->isVisible()) {
-            obj->onCamera(oldState, newState);
-        }
-    }
 }
 
 void QGVItem::onUpdate()
 {
 }
 
+void QGVItem::onChildAdded(QGVItem* /*item*/)
+{
+}
+
+void QGVItem::onChildRemoved(QGVItem* /*item*/)
+{
+}
+
+void QGVItem::onChildGeometry(QGVItem* /*item*/)
+{
+}
+
+void QGVItem::updateCameraItems(QGVMap* oldMap, QGVMap* newMap)
+{
+    if (mCameraDependent) {
+        if (oldMap != nullptr) {
+            oldMap->removeCameraItem(this);
+        }
+        if (newMap != nullptr) {
+            newMap->addCameraItem(this);
+        }
+    }
+    for (QGVItem* obj : mChildrens) {
+        obj->updateCameraItems(oldMap, newMap);
+    }
+}
+
 void QGVItem::onClean()
 {
     for (QGVItem* obj : mChildrens) {
         obj->onClean();
     }
 }
+
+void QGVItem::collectItems(QVector<QGVItem*>& items)
+{
+    items.append(this);
+    for (QGVItem* obj : mChildrens) {
+        obj->collectItems(items);
+    }
+}
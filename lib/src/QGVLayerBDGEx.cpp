@@ -85,3 +85,8 @@ QString QGVLayerBDGEx::tilePosToUrl(const QGV::GeoTilePos& tilePos) const
     url.replace("HEIGHT", QString::number(height_pixels));
     return url;
 }
+
+QGV::Projection QGVLayerBDGEx::tileProjection() const
+{
+    return (mUrl.contains("EPSG%3A3857")) ? QGV::Projection::EPSG3857 : QGV::Projection::EPSG4326;
+}
@@ -0,0 +1,330 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "QGVLayerClusters.h"
+#include "QGVLayerPaintItem.h"
+
+#include <QPainter>
+#include <QtMath>
+
+#include <cmath>
+#include <limits>
+
+namespace {
+const int minClusterZoom = -8;
+const int maxClusterZoom = 30;
+
+int clusterZoom(double scale)
+{
+    return qBound(minClusterZoom, QGV::scaleToZoom(scale), maxClusterZoom);
+}
+
+qint64 cellIndex(double coord, double cellSize)
+{
+    return static_cast<qint64>(std::floor(coord / cellSize));
+}
+
+quint64 cellKey(qint64 x, qint64 y)
+{
+    return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y);
+}
+}
+
+QGVLayerClusters::QGVLayerClusters()
+    : mItem(new QGVLayerPaintItem([this]() { return projBoundingRect(); },
+                                  [this](QPainter* painter) { projPaint(painter); }))
+    , mCellSize(64)
+    , mClusterColor(Qt::darkBlue)
+    , mZoom(std::numeric_limits<int>::min())
+    , mRebuilding(false)
+{
+    setCameraDependent(true);
+    addItem(mItem);
+}
+
+void QGVLayerClusters::setCellSize(int pixels)
+{
+    mCellSize = qMax(1, pixels);
+    mLevels.clear();
+    applyLevel();
+}
+
+int QGVLayerClusters::getCellSize() const
+{
+    return mCellSize;
+}
+
+void QGVLayerClusters::setClusterColor(const QColor& color)
+{
+    mClusterColor = color;
+    mItem->repaint();
+}
+
+QColor QGVLayerClusters::getClusterColor() const
+{
+    return mClusterColor;
+}
+
+int QGVLayerClusters::getZoom() const
+{
+    return mZoom;
+}
+
+int QGVLayerClusters::countClusters() const
+{
+    const auto iter = mLevels.constFind(mZoom);
+    return (iter != mLevels.constEnd()) ? iter->cells.size() : 0;
+}
+
+void QGVLayerClusters::onProjection(QGVMap* geoMap)
+{
+    mRebuilding = true;
+    QGVLayer::onProjection(geoMap);
+    mRebuilding = false;
+    mItem->resetBoundary();
+    rebuild();
+}
+
+void QGVLayerClusters::onCamera(const QGVCameraState& oldState, const QGVCameraState& newState)
+{
+    QGVLayer::onCamera(oldState, newState);
+    const int zoom = clusterZoom(newState.scale());
+    if (zoom != mZoom) {
+        mZoom = zoom;
+        applyLevel();
+    }
+}
+
+void QGVLayerClusters::onChildAdded(QGVItem* item)
+{
+    QGVDrawItem* drawItem = qobject_cast<QGVDrawItem*>(item);
+    if (getMap() == nullptr || drawItem == nullptr || drawItem == mItem) {
+        return;
+    }
+    const QPointF projPos = drawItem->projAnchor();
+    mItemPos.insert(item, projPos);
+    for (auto iter = mLevels.begin(); iter != mLevels.end(); ++iter) {
+        const quint64 key = insertToLevel(iter.value(), item, projPos);
+        if (iter.key() == mZoom) {
+            updateCluster(iter.value(), key);
+        }
+    }
+    mItem->repaint();
+}
+
+void QGVLayerClusters::onChildRemoved(QGVItem* item)
+{
+    const auto posIter = mItemPos.find(item);
+    if (posIter == mItemPos.end()) {
+        return;
+    }
+    const QPointF projPos = posIter.value();
+    mItemPos.erase(posIter);
+    for (auto iter = mLevels.begin(); iter != mLevels.end(); ++iter) {
+        const quint64 key = removeFromLevel(iter.value(), item, projPos);
+        if (iter.key() == mZoom) {
+            updateCluster(iter.value(), key);
+        }
+    }
+    // Deleted children still point to this layer and must not be touched
+    if (mHidden.remove(item) && item->getParent() != this) {
+        item->setAutoHidden(false);
+    }
+    mItem->repaint();
+}
+
+void QGVLayerClusters::onChildGeometry(QGVItem* item)
+{
+    if (mRebuilding) {
+        return;
+    }
+    const auto posIter = mItemPos.find(item);
+    if (posIter == mItemPos.end()) {
+        return;
+    }
+    const QPointF oldPos = posIter.value();
+    const QPointF newPos = static_cast<QGVDrawItem*>(item)->projAnchor();
+    if (oldPos == newPos) {
+        return;
+    }
+    posIter.value() = newPos;
+    for (auto iter = mLevels.begin(); iter != mLevels.end(); ++iter) {
+        const quint64 oldKey = removeFromLevel(iter.value(), item, oldPos);
+        const quint64 newKey = insertToLevel(iter.value(), item, newPos);
+        if (iter.key() == mZoom && oldKey != newKey) {
+            updateCluster(iter.value(), oldKey);
+            updateCluster(iter.value(), newKey);
+        }
+    }
+    mItem->repaint();
+}
+
+QGVLayerClusters::Level& QGVLayerClusters::level(int zoom)
+{
+    auto iter = mLevels.find(zoom);
+    if (iter != mLevels.end()) {
+        return iter.value();
+    }
+    Level& newLevel = mLevels[zoom];
+    newLevel.cellSize = std::ldexp(static_cast<double>(mCellSize), 17 - zoom);
+    for (auto posIter = mItemPos.constBegin(); posIter != mItemPos.constEnd(); ++posIter) {
+        insertToLevel(newLevel, posIter.key(), posIter.value());
+    }
+    return newLevel;
+}
+
+quint64 QGVLayerClusters::insertToLevel(Level& level, QGVItem* item, const QPointF& projPos)
+{
+    const quint64 key = cellKey(cellIndex(projPos.x(), level.cellSize), cellIndex(projPos.y(), level.cellSize));
+    Cluster& cluster = level.cells[key];
+    cluster.items.append(item);
+    cluster.projSum += projPos;
+    level.itemCells.insert(item, key);
+    return key;
+}
+
+quint64 QGVLayerClusters::removeFromLevel(Level& level, QGVItem* item, const QPointF& projPos)
+{
+    const quint64 key = level.itemCells.take(item);
+    const auto iter = level.cells.find(key);
+    if (iter != level.cells.end()) {
+        iter->items.removeOne(item);
+        iter->projSum -= projPos;
+        if (iter->items.isEmpty()) {
+            level.cells.erase(iter);
+        }
+    }
+    return key;
+}
+
+void QGVLayerClusters::updateCluster(const Level& level, quint64 key)
+{
+    const auto iter = level.cells.constFind(key);
+    if (iter == level.cells.constEnd()) {
+        return;
+    }
+    const bool hidden = (iter->items.size() > 1);
+    for (QGVItem* item : iter->items) {
+        setHidden(item, hidden);
+    }
+}
+
+void QGVLayerClusters::setHidden(QGVItem* item, bool hidden)
+{
+    if (hidden) {
+        if (!mHidden.contains(item)) {
+            mHidden.insert(item);
+            item->setAutoHidden(true);
+        }
+    } else if (mHidden.remove(item)) {
+        item->setAutoHidden(false);
+    }
+}
+
+void QGVLayerClusters::applyLevel()
+{
+    if (getMap() == nullptr || mZoom == std::numeric_limits<int>::min()) {
+        return;
+    }
+    const Level& current = level(mZoom);
+    for (auto iter = current.cells.constBegin(); iter != current.cells.constEnd(); ++iter) {
+        const bool hidden = (iter->items.size() > 1);
+        for (QGVItem* item : iter->items) {
+            setHidden(item, hidden);
+        }
+    }
+    mItem->repaint();
+}
+
+void QGVLayerClusters::rebuild()
+{
+    mLevels.clear();
+    mItemPos.clear();
+    for (int i = 0; i < countItems(); ++i) {
+        QGVDrawItem* drawItem = qobject_cast<QGVDrawItem*>(getItem(i));
+        if (drawItem != nullptr && drawItem != mItem) {
+            mItemPos.insert(drawItem, drawItem->projAnchor());
+        }
+    }
+    mZoom = clusterZoom(getMap()->getCamera().scale());
+    applyLevel();
+}
+
+QRectF QGVLayerClusters::projBoundingRect() const
+{
+    if (getMap() == nullptr) {
+        return {};
+    }
+    return getMap()->getProjection()->boundaryProjRect();
+}
+
+void QGVLayerClusters::projPaint(QPainter* painter)
+{
+    const auto levelIter = mLevels.constFind(mZoom);
+    if (levelIter == mLevels.constEnd()) {
+        return;
+    }
+    const double margin = levelIter->cellSize;
+    const QRectF area = getMap()->getCamera().projRect().adjusted(-margin, -margin, margin, margin);
+    const QTransform transform = painter->transform();
+    const QColor textColor = (mClusterColor.lightnessF() < 0.5) ? QColor(Qt::white) : QColor(Qt::black);
+
+    painter->save();
+    painter->resetTransform();
+    const auto paintCluster = [&](const Cluster& cluster) {
+        const int count = cluster.items.size();
+        if (count < 2) {
+            return;
+        }
+        const QPointF projCenter = cluster.projSum / count;
+        if (!area.contains(projCenter)) {
+            return;
+        }
+        const QPointF center = transform.map(projCenter);
+        const double radius = 10 + 4 * std::log10(static_cast<double>(count));
+        painter->setPen(QPen(mClusterColor.darker(), 1));
+        painter->setBrush(mClusterColor);
+        painter->drawEllipse(center, radius, radius);
+        painter->setPen(textColor);
+        painter->drawText(QRectF(center - QPointF(radius, radius), QSizeF(2 * radius, 2 * radius)),
+                          Qt::AlignCenter,
+                          QString::number(count));
+    };
+
+    // Only cells covered by area are looked up, unless area holds more cells than the level has
+    const Level& paintLevel = *levelIter;
+    const qint64 left = cellIndex(area.left(), paintLevel.cellSize);
+    const qint64 right = cellIndex(area.right(), paintLevel.cellSize);
+    const qint64 top = cellIndex(area.top(), paintLevel.cellSize);
+    const qint64 bottom = cellIndex(area.bottom(), paintLevel.cellSize);
+    if ((right - left + 1) * (bottom - top + 1) > paintLevel.cells.size()) {
+        for (const Cluster& cluster : paintLevel.cells) {
+            paintCluster(cluster);
+        }
+    } else {
+        for (qint64 y = top; y <= bottom; ++y) {
+            for (qint64 x = left; x <= right; ++x) {
+                const auto cellIter = paintLevel.cells.constFind(cellKey(x, y));
+                if (cellIter != paintLevel.cells.constEnd()) {
+                    paintCluster(cellIter.value());
+                }
+            }
+        }
+    }
+    painter->restore();
+}
@@ -0,0 +1,421 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "QGVLayerHeatmap.h"
+#include "Raster/QGVImage.h"
+
+#include <QLinearGradient>
+#include <QPainter>
+#include <QRunnable>
+#include <QtMath>
+
+#include <algorithm>
+
+namespace {
+const int tileSize = 256;
+const int gridSide = 256;
+const int cancelCheckPoints = 4096;
+}
+
+struct QGVLayerHeatmapData
+{
+    // Projected coordinates normalized to projection boundary, ordered by grid cell
+    QRectF world;
+    QVector<double> x;
+    QVector<double> y;
+    QVector<float> weight;
+    QVector<int> cellStart;
+};
+
+struct QGVLayerHeatmapStyle
+{
+    int radius;
+    float weightFactor;
+    QVector<float> kernel;
+    QVector<QRgb> colors;
+};
+
+class QGVLayerHeatmapTask : public QRunnable
+{
+public:
+    QGVLayerHeatmapTask(QGVLayerHeatmap* layer,
+                        const QSharedPointer<const QGVLayerHeatmapData>& data,
+                        const QSharedPointer<const QGVLayerHeatmapStyle>& style,
+                        const QGV::GeoTilePos& tilePos,
+                        const QRectF& tileRect,
+                        const QSharedPointer<QAtomicInt>& token)
+        : mLayer(layer)
+        , mData(data)
+        , mStyle(style)
+        , mTilePos(tilePos)
+        , mTileRect(tileRect)
+        , mToken(token)
+    {
+    }
+
+    void run() override
+    {
+        if (mToken->loadAcquire() != 0) {
+            return;
+        }
+        const QImage image = render();
+        if (mToken->loadAcquire() != 0) {
+            return;
+        }
+        QGVLayerHeatmap* layer = mLayer;
+        const QGV::GeoTilePos tilePos = mTilePos;
+        const QSharedPointer<QAtomicInt> token = mToken;
+        QMetaObject::invokeMethod(
+                layer, [layer, tilePos, token, image]() { layer->onTileRendered(tilePos, token, image); },
+                Qt::QueuedConnection);
+    }
+
+private:
+    QImage render() const
+    {
+        const QGVLayerHeatmapData& data = *mData;
+        const QGVLayerHeatmapStyle& style = *mStyle;
+        const int radius = style.radius;
+        const int kernelSide = 2 * radius + 1;
+        if (mTileRect.width() <= 0 || mTileRect.height() <= 0) {
+            return {};
+        }
+        // Tile image is stretched over projected tile rect, so pixels are linear in normalized coordinates
+        const double scaleX = tileSize / mTileRect.width();
+        const double scaleY = tileSize / mTileRect.height();
+        const double originX = mTileRect.left();
+        const double originY = mTileRect.top();
+
+        const double marginX = radius / scaleX;
+        const double marginY = radius / scaleY;
+        const int cellLeft = qBound(0, qFloor((mTileRect.left() - marginX) * gridSide), gridSide - 1);
+        const int cellRight = qBound(0, qFloor((mTileRect.right() + marginX) * gridSide), gridSide - 1);
+        const int cellTop = qBound(0, qFloor((mTileRect.top() - marginY) * gridSide), gridSide - 1);
+        const int cellBottom = qBound(0, qFloor((mTileRect.bottom() + marginY) * gridSide), gridSide - 1);
+
+        QVector<float> density(tileSize * tileSize, 0.0f);
+        float* grid = density.data();
+        const float* kernel = style.kernel.constData();
+        const double* x = data.x.constData();
+        const double* y = data.y.constData();
+        const float* weight = data.weight.constData();
+        bool touched = false;
+        int processed = 0;
+        for (int cellY = cellTop; cellY <= cellBottom; ++cellY) {
+            const int rowStart = data.cellStart.at(cellY * gridSide + cellLeft);
+            const int rowEnd = data.cellStart.at(cellY * gridSide + cellRight + 1);
+            for (int i = rowStart; i < rowEnd; ++i) {
+                if (++processed == cancelCheckPoints) {
+                    processed = 0;
+                    if (mToken->loadAcquire() != 0) {
+                        return {};
+                    }
+                }
+                const int px = qFloor((x[i] - originX) * scaleX);
+                const int py = qFloor((y[i] - originY) * scaleY);
+                const int x0 = qMax(0, px - radius);
+                const int x1 = qMin(tileSize - 1, px + radius);
+                const int y0 = qMax(0, py - radius);
+                const int y1 = qMin(tileSize - 1, py + radius);
+                if (x0 > x1 || y0 > y1) {
+                    continue;
+                }
+                touched = true;
+                const float w = weight[i];
+                const int width = x1 - x0 + 1;
+                for (int row = y0; row <= y1; ++row) {
+                    float* target = grid + row * tileSize + x0;
+                    const float* source = kernel + (row - py + radius) * kernelSide + (x0 - px + radius);
+                    for (int k = 0; k < width; ++k) {
+                        target[k] += w * source[k];
+                    }
+                }
+            }
+        }
+        if (!touched) {
+            return {};
+        }
+
+        QImage image(tileSize, tileSize, QImage::Format_ARGB32_Premultiplied);
+        const QRgb* colors = style.colors.constData();
+        const float factor = style.weightFactor * (style.colors.size() - 1);
+        const float maxIndex = style.colors.size() - 1;
+        for (int row = 0; row < tileSize; ++row) {
+            QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(row));
+            const float* values = grid + row * tileSize;
+            for (int col = 0; col < tileSize; ++col) {
+                line[col] = colors[static_cast<int>(qMin(values[col] * factor, maxIndex))];
+            }
+        }
+        return image;
+    }
+
+private:
+    QGVLayerHeatmap* mLayer;
+    QSharedPointer<const QGVLayerHeatmapData> mData;
+    QSharedPointer<const QGVLayerHeatmapStyle> mStyle;
+    QGV::GeoTilePos mTilePos;
+    QRectF mTileRect;
+    QSharedPointer<QAtomicInt> mToken;
+};
+
+QGVLayerHeatmap::QGVLayerHeatmap()
+    : mRadius(16)
+    , mMaxWeight(10)
+{
+    mGradient << QGradientStop(0.0, QColor(0, 0, 255, 0)) << QGradientStop(0.2, QColor(0, 0, 255, 160))
+              << QGradientStop(0.4, QColor(0, 255, 255, 192)) << QGradientStop(0.6, QColor(0, 255, 0, 208))
+              << QGradientStop(0.8, QColor(255, 255, 0, 224)) << QGradientStop(1.0, QColor(255, 0, 0, 240));
+    mData = QSharedPointer<QGVLayerHeatmapData>::create();
+    mCache.setMaxCost(64 * 1024);
+    updateStyle();
+}
+
+QGVLayerHeatmap::~QGVLayerHeatmap()
+{
+    for (const auto& token : mRequests) {
+        token->storeRelease(1);
+    }
+    mPool.clear();
+    mPool.waitForDone();
+}
+
+void QGVLayerHeatmap::setPoints(const double* lats, const double* lons, const double* weights, int count)
+{
+    Q_ASSERT(count >= 0);
+    Q_ASSERT(count == 0 || (lats != nullptr && lons != nullptr));
+    mGeoPoints.clear();
+    mGeoPoints.reserve(count);
+    mWeights.resize(count);
+    for (int i = 0; i < count; ++i) {
+        mGeoPoints.append(lats[i], lons[i]);
+        mWeights[i] = (weights != nullptr) ? static_cast<float>(weights[i]) : 1.0f;
+    }
+    updateData();
+}
+
+void QGVLayerHeatmap::clearPoints()
+{
+    setPoints(nullptr, nullptr, nullptr, 0);
+}
+
+int QGVLayerHeatmap::countPoints() const
+{
+    return mGeoPoints.size();
+}
+
+void QGVLayerHeatmap::setRadius(int pixels)
+{
+    mRadius = qMax(1, pixels);
+    updateStyle();
+}
+
+int QGVLayerHeatmap::getRadius() const
+{
+    return mRadius;
+}
+
+void QGVLayerHeatmap::setMaxWeight(double weight)
+{
+    mMaxWeight = weight;
+    updateStyle();
+}
+
+double QGVLayerHeatmap::getMaxWeight() const
+{
+    return mMaxWeight;
+}
+
+void QGVLayerHeatmap::setGradient(const QGradientStops& stops)
+{
+    mGradient = stops;
+    updateStyle();
+}
+
+QGradientStops QGVLayerHeatmap::getGradient() const
+{
+    return mGradient;
+}
+
+int QGVLayerHeatmap::minZoomlevel() const
+{
+    return 0;
+}
+
+int QGVLayerHeatmap::maxZoomlevel() const
+{
+    return 21;
+}
+
+void QGVLayerHeatmap::request(const QGV::GeoTilePos& tilePos)
+{
+    const auto token = QSharedPointer<QAtomicInt>::create(0);
+    mRequests[tilePos] = token;
+
+    const QImage* cached = mCache.object(tilePos.mortonKey());
+    if (cached != nullptr) {
+        const QImage image = *cached;
+        QMetaObject::invokeMethod(
+                this, [this, tilePos, token, image]() { onTileRendered(tilePos, token, image); }, Qt::QueuedConnection);
+        return;
+    }
+    const QRectF world = mData->world;
+    if (world.isEmpty()) {
+        QMetaObject::invokeMethod(
+                this, [this, tilePos, token]() { onTileRendered(tilePos, token, QImage()); }, Qt::QueuedConnection);
+        return;
+    }
+    const QRectF tileProjRect = getMap()->getProjection()->geoToProj(tilePos.toGeoRect()).normalized();
+    const QRectF tileRect((tileProjRect.left() - world.left()) / world.width(),
+                          (tileProjRect.top() - world.top()) / world.height(),
+                          tileProjRect.width() / world.width(),
+                          tileProjRect.height() / world.height());
+    mPool.start(new QGVLayerHeatmapTask(this, mData, mStyle, tilePos, tileRect, token));
+}
+
+void QGVLayerHeatmap::cancel(const QGV::GeoTilePos& tilePos)
+{
+    const auto token = mRequests.take(tilePos);
+    if (!token.isNull()) {
+        token->storeRelease(1);
+    }
+}
+
+void QGVLayerHeatmap::updateStyle()
+{
+    auto style = QSharedPointer<QGVLayerHeatmapStyle>::create();
+    style->radius = mRadius;
+    style->weightFactor = (mMaxWeight > 0) ? static_cast<float>(1.0 / mMaxWeight) : 0.0f;
+
+    const int kernelSide = 2 * mRadius + 1;
+    style->kernel.resize(kernelSide * kernelSide);
+    for (int row = 0; row < kernelSide; ++row) {
+        for (int col = 0; col < kernelSide; ++col) {
+            const double dx = col - mRadius;
+            const double dy = row - mRadius;
+            const double falloff = qMax(0.0, 1.0 - (dx * dx + dy * dy) / (mRadius * mRadius));
+            style->kernel[row * kernelSide + col] = static_cast<float>(falloff * falloff);
+        }
+    }
+
+    QImage palette(256, 1, QImage::Format_ARGB32_Premultiplied);
+    palette.fill(Qt::transparent);
+    QLinearGradient gradient(0, 0, palette.width(), 0);
+    gradient.setStops(mGradient);
+    QPainter painter(&palette);
+    painter.fillRect(palette.rect(), gradient);
+    painter.end();
+    style->colors.resize(palette.width());
+    const QRgb* line = reinterpret_cast<const QRgb*>(palette.constScanLine(0));
+    std::copy(line, line + palette.width(), style->colors.begin());
+    style->colors[0] = qRgba(0, 0, 0, 0);
+
+    mStyle = style;
+    resetTiles();
+}
+
+void QGVLayerHeatmap::onProjection(QGVMap* geoMap)
+{
+    QGVLayerTiles::onProjection(geoMap);
+    updateData();
+}
+
+void QGVLayerHeatmap::updateData()
+{
+    auto data = QSharedPointer<QGVLayerHeatmapData>::create();
+    const int count = mGeoPoints.size();
+    if (getMap() == nullptr || count == 0) {
+        mData = data;
+        resetTiles();
+        return;
+    }
+
+    // Points are normalized through current projection, grid cells split its boundary
+    const QGVProjection* projection = getMap()->getProjection();
+    const QRectF world = projection->boundaryProjRect().normalized();
+    QVector<double> x(count);
+    QVector<double> y(count);
+    mGeoPoints.toProj(projection, x.data(), y.data());
+    QVector<int> cells(count);
+    QVector<int> cellStart(gridSide * gridSide + 1, 0);
+    for (int i = 0; i < count; ++i) {
+        x[i] = qBound(0.0, (x[i] - world.left()) / world.width(), 1.0);
+        y[i] = qBound(0.0, (y[i] - world.top()) / world.height(), 1.0);
+        const int cellX = qBound(0, static_cast<int>(x[i] * gridSide), gridSide - 1);
+        const int cellY = qBound(0, static_cast<int>(y[i] * gridSide), gridSide - 1);
+        cells[i] = cellY * gridSide + cellX;
+        cellStart[cells[i] + 1]++;
+    }
+    for (int cell = 1; cell < cellStart.size(); ++cell) {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+
+    data->world = world;
+    data->x.resize(count);
+    data->y.resize(count);
+    data->weight.resize(count);
+    QVector<int> cursor = cellStart;
+    for (int i = 0; i < count; ++i) {
+        const int index = cursor[cells[i]]++;
+        data->x[index] = x[i];
+        data->y[index] = y[i];
+        data->weight[index] = mWeights.at(i);
+    }
+    data->cellStart = cellStart;
+    mData = data;
+    resetTiles();
+}
+
+void QGVLayerHeatmap::resetTiles()
+{
+    for (const auto& token : mRequests) {
+        token->storeRelease(1);
+    }
+    mRequests.clear();
+    mCache.clear();
+    if (getMap() != nullptr) {
+        QGVLayerTiles::onClean();
+        update();
+    }
+}
+
+void QGVLayerHeatmap::onTileRendered(const QGV::GeoTilePos& tilePos,
+                                     const QSharedPointer<QAtomicInt>& token,
+                                     const QImage& image)
+{
+    const auto iter = mRequests.find(tilePos);
+    if (iter == mRequests.end() || iter.value() != token) {
+        return;
+    }
+    mRequests.erase(iter);
+    if (!mCache.contains(tilePos.mortonKey())) {
+        mCache.insert(tilePos.mortonKey(), new QImage(image), qMax(1, static_cast<int>(image.sizeInBytes() / 1024)));
+    }
+
+    auto tile = new QGVImage();
+    tile->setGeometry(tilePos.toGeoRect());
+    if (!image.isNull()) {
+        tile->loadImage(image);
+    }
+    tile->setProperty("drawDebug",
+                      QString("heatmap\ntile(%1,%2,%3)")
+                              .arg(tilePos.zoom())
+                              .arg(tilePos.pos().x())
+                              .arg(tilePos.pos().y()));
+    onTile(tilePos, tile);
+}
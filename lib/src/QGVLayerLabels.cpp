@@ -0,0 +1,246 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "QGVLayerLabels.h"
+#include "QGVLayerPaintItem.h"
+
+#include <QPainter>
+#include <QtMath>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double labelGap = 4;
+const double gridCellSize = 128;
+
+int scaleToBucket(double scale)
+{
+    return qFloor(2 * qLn(scale) * M_LOG2E);
+}
+
+quint64 cellKey(int x, int y)
+{
+    return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y);
+}
+}
+
+QGVLayerLabels::QGVLayerLabels()
+    : mItem(new QGVLayerPaintItem([this]() { return projBoundingRect(); },
+                                  [this](QPainter* painter) { projPaint(painter); }))
+    , mColor(Qt::black)
+    , mNextId(0)
+    , mAzimuth(0)
+    , mLastBucket(0)
+{
+    addItem(mItem);
+}
+
+int QGVLayerLabels::addLabel(const QGV::GeoPos& geoPos, const QString& text, int priority)
+{
+    Label label;
+    label.geoPos = geoPos;
+    label.text.setText(text);
+    label.text.setTextFormat(Qt::PlainText);
+    label.text.prepare(QTransform(), mFont);
+    label.priority = priority;
+    if (getMap() != nullptr) {
+        label.projPos = getMap()->getProjection()->geoToProj(geoPos);
+    }
+    const int id = mNextId++;
+    mLabels.insert(id, label);
+    mOrder.clear();
+    invalidatePlacements();
+    return id;
+}
+
+void QGVLayerLabels::removeLabel(int id)
+{
+    if (mLabels.remove(id) > 0) {
+        mOrder.clear();
+        invalidatePlacements();
+    }
+}
+
+void QGVLayerLabels::clearLabels()
+{
+    mLabels.clear();
+    mOrder.clear();
+    invalidatePlacements();
+}
+
+int QGVLayerLabels::countLabels() const
+{
+    return mLabels.size();
+}
+
+void QGVLayerLabels::setFont(const QFont& font)
+{
+    mFont = font;
+    for (Label& label : mLabels) {
+        label.text.prepare(QTransform(), mFont);
+    }
+    invalidatePlacements();
+}
+
+QFont QGVLayerLabels::getFont() const
+{
+    return mFont;
+}
+
+void QGVLayerLabels::setColor(const QColor& color)
+{
+    mColor = color;
+    mItem->repaint();
+}
+
+QColor QGVLayerLabels::getColor() const
+{
+    return mColor;
+}
+
+int QGVLayerLabels::countPlaced() const
+{
+    const auto iter = mPlacements.constFind(mLastBucket);
+    return (iter != mPlacements.constEnd()) ? iter->size() : 0;
+}
+
+void QGVLayerLabels::onProjection(QGVMap* geoMap)
+{
+    QGVLayer::onProjection(geoMap);
+    const QGVProjection* projection = geoMap->getProjection();
+    for (Label& label : mLabels) {
+        label.projPos = projection->geoToProj(label.geoPos);
+    }
+    mItem->resetBoundary();
+    invalidatePlacements();
+}
+
+void QGVLayerLabels::invalidatePlacements()
+{
+    mPlacements.clear();
+    mItem->repaint();
+}
+
+const QVector<QGVLayerLabels::Placement>& QGVLayerLabels::placements(int bucket, double azimuth)
+{
+    if (!qFuzzyCompare(azimuth + 1.0, mAzimuth + 1.0)) {
+        mAzimuth = azimuth;
+        mPlacements.clear();
+    }
+    mLastBucket = bucket;
+    const auto iter = mPlacements.constFind(bucket);
+    if (iter != mPlacements.constEnd()) {
+        return iter.value();
+    }
+
+    if (mOrder.isEmpty()) {
+        mOrder.reserve(mLabels.size());
+        for (auto iter = mLabels.constBegin(); iter != mLabels.constEnd(); ++iter) {
+            mOrder.append(iter.key());
+        }
+        std::sort(mOrder.begin(), mOrder.end(), [this](int left, int right) {
+            const int leftPriority = mLabels.constFind(left)->priority;
+            const int rightPriority = mLabels.constFind(right)->priority;
+            return (leftPriority != rightPriority) ? leftPriority > rightPriority : left < right;
+        });
+    }
+
+    // Placement is done at the smallest scale of the bucket, so labels don't collide anywhere inside it
+    const double bucketScale = std::exp2(bucket / 2.0);
+    const QTransform screen = QTransform().rotate(azimuth).scale(bucketScale, bucketScale);
+    QHash<quint64, QVector<QRectF>> grid;
+    QVector<Placement>& result = mPlacements[bucket];
+    for (int id : mOrder) {
+        const Label& label = *mLabels.constFind(id);
+        const QSizeF size = label.text.size();
+        const QPointF anchor = screen.map(label.projPos);
+        const QPointF candidates[] = {
+            QPointF(labelGap, -size.height() / 2),
+            QPointF(-size.width() - labelGap, -size.height() / 2),
+            QPointF(-size.width() / 2, -size.height() - labelGap),
+            QPointF(-size.width() / 2, labelGap),
+        };
+        for (const QPointF& offset : candidates) {
+            const QRectF rect(anchor + offset, size);
+            const int left = qFloor(rect.left() / gridCellSize);
+            const int right = qFloor(rect.right() / gridCellSize);
+            const int top = qFloor(rect.top() / gridCellSize);
+            const int bottom = qFloor(rect.bottom() / gridCellSize);
+            bool collides = false;
+            for (int x = left; x <= right && !collides; ++x) {
+                for (int y = top; y <= bottom && !collides; ++y) {
+                    const auto cellIter = grid.constFind(cellKey(x, y));
+                    if (cellIter == grid.constEnd()) {
+                        continue;
+                    }
+                    for (const QRectF& placed : cellIter.value()) {
+                        if (placed.intersects(rect)) {
+                            collides = true;
+                            break;
+                        }
+                    }
+                }
+            }
+            if (collides) {
+                continue;
+            }
+            for (int x = left; x <= right; ++x) {
+                for (int y = top; y <= bottom; ++y) {
+                    grid[cellKey(x, y)].append(rect);
+                }
+            }
+            result.append({ id, offset });
+            break;
+        }
+    }
+    return result;
+}
+
+QRectF QGVLayerLabels::projBoundingRect() const
+{
+    if (getMap() == nullptr) {
+        return {};
+    }
+    return getMap()->getProjection()->boundaryProjRect();
+}
+
+void QGVLayerLabels::projPaint(QPainter* painter)
+{
+    if (mLabels.isEmpty()) {
+        return;
+    }
+    const QGVCameraState camera = getMap()->getCamera();
+    const QVector<Placement>& placed = placements(scaleToBucket(camera.scale()), camera.azimuth());
+    const QTransform transform = painter->transform();
+    const QRect deviceRect = painter->viewport();
+
+    painter->save();
+    painter->resetTransform();
+    painter->setPen(mColor);
+    painter->setFont(mFont);
+    for (const Placement& placement : placed) {
+        const Label& label = *mLabels.constFind(placement.id);
+        const QPointF pos = transform.map(label.projPos) + placement.offset;
+        if (!QRectF(pos, label.text.size()).intersects(deviceRect)) {
+            continue;
+        }
+        painter->drawStaticText(pos, label.text);
+    }
+    painter->restore();
+}
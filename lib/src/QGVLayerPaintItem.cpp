@@ -0,0 +1,44 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "QGVLayerPaintItem.h"
+
+QGVLayerPaintItem::QGVLayerPaintItem(const std::function<QRectF()>& boundingRect,
+                                     const std::function<void(QPainter*)>& paint)
+    : mBoundingRect(boundingRect)
+    , mPaint(paint)
+{
+    setCacheMode(QGraphicsItem::NoCache);
+}
+
+QGVLayerPaintItem::~QGVLayerPaintItem() = default;
+
+QRectF QGVLayerPaintItem::projBoundingRect() const
+{
+    return mBoundingRect();
+}
+
+QPainterPath QGVLayerPaintItem::projShape() const
+{
+    return {};
+}
+
+void QGVLayerPaintItem::projPaint(QPainter* painter)
+{
+    mPaint(painter);
+}
@@ -0,0 +1,332 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "QGVLayerPlayback.h"
+
+#include <algorithm>
+
+namespace {
+const int seekThreshold = 64;
+}
+
+QGVLayerPlayback::QGVLayerPlayback()
+    : mIndexDirty(false)
+    , mTreeRoot(-1)
+    , mTime(0)
+    , mRate(1.0)
+    , mClockOrigin(0)
+{
+    mTimer.setInterval(40);
+    connect(&mTimer, &QTimer::timeout, this, &QGVLayerPlayback::onTick);
+}
+
+void QGVLayerPlayback::addFeature(QGVItem* item, qint64 from, qint64 to)
+{
+    Q_ASSERT(item);
+    addItem(item);
+    setFeatureInterval(item, from, to);
+}
+
+void QGVLayerPlayback::setFeatureInterval(QGVItem* item, qint64 from, qint64 to)
+{
+    Q_ASSERT(item && item->getParent() == this);
+    mIndexDirty = true;
+    const auto iter = mFeatureIndex.constFind(item);
+    if (iter == mFeatureIndex.constEnd()) {
+        const int index = mFeatures.size();
+        mFeatureIndex.insert(item, index);
+        mFeatures.append({ item, from, to });
+        const bool active = isActiveAt(mFeatures.at(index), mTime);
+        if (active) {
+            mActive.insert(index);
+        }
+        setHidden(item, !active);
+        return;
+    }
+    Feature& feature = mFeatures[iter.value()];
+    feature.from = from;
+    feature.to = to;
+    setActive(iter.value(), isActiveAt(feature, mTime));
+}
+
+int QGVLayerPlayback::countFeatures() const
+{
+    return mFeatures.size();
+}
+
+int QGVLayerPlayback::countActive() const
+{
+    return mActive.size();
+}
+
+void QGVLayerPlayback::setTime(qint64 time)
+{
+    if (time == mTime) {
+        return;
+    }
+    if (mIndexDirty) {
+        rebuildIndex();
+    }
+
+    // Boundaries crossed between old and new time tell which features may change state
+    const qint64 low = qMin(mTime, time);
+    const qint64 high = qMax(mTime, time);
+    const auto byTime = [](const Boundary& boundary, qint64 value) { return boundary.time <= value; };
+    const int crossed = static_cast<int>(
+            (std::lower_bound(mStarts.begin(), mStarts.end(), high, byTime) -
+             std::lower_bound(mStarts.begin(), mStarts.end(), low, byTime)) +
+            (std::lower_bound(mEnds.begin(), mEnds.end(), high, byTime) -
+             std::lower_bound(mEnds.begin(), mEnds.end(), low, byTime)));
+    if (crossed > 2 * mActive.size() + seekThreshold) {
+        seek(time);
+    } else {
+        sweep(mTime, time);
+    }
+    mTime = time;
+    Q_EMIT timeChanged(mTime);
+}
+
+qint64 QGVLayerPlayback::getTime() const
+{
+    return mTime;
+}
+
+void QGVLayerPlayback::setRate(double rate)
+{
+    if (isPlaying()) {
+        mClockOrigin = mTime;
+        mClock.restart();
+    }
+    mRate = rate;
+}
+
+double QGVLayerPlayback::getRate() const
+{
+    return mRate;
+}
+
+void QGVLayerPlayback::setTickInterval(int msecs)
+{
+    mTimer.setInterval(msecs);
+}
+
+int QGVLayerPlayback::getTickInterval() const
+{
+    return mTimer.interval();
+}
+
+void QGVLayerPlayback::play()
+{
+    if (isPlaying()) {
+        return;
+    }
+    mClockOrigin = mTime;
+    mClock.start();
+    mTimer.start();
+}
+
+void QGVLayerPlayback::pause()
+{
+    mTimer.stop();
+    mClock.invalidate();
+}
+
+bool QGVLayerPlayback::isPlaying() const
+{
+    return mTimer.isActive();
+}
+
+void QGVLayerPlayback::onChildRemoved(QGVItem* item)
+{
+    QGVLayer::onChildRemoved(item);
+    const auto iter = mFeatureIndex.find(item);
+    if (iter == mFeatureIndex.end()) {
+        return;
+    }
+    const int index = iter.value();
+    mFeatureIndex.erase(iter);
+    mActive.remove(index);
+    // Deleted children still point to this layer and must not be touched
+    if (mHidden.remove(item) && item->getParent() != this) {
+        item->setAutoHidden(false);
+    }
+
+    const int last = mFeatures.size() - 1;
+    if (index != last) {
+        mFeatures[index] = mFeatures.at(last);
+        mFeatureIndex[mFeatures.at(index).item] = index;
+        if (mActive.remove(last)) {
+            mActive.insert(index);
+        }
+    }
+    mFeatures.removeLast();
+    mIndexDirty = true;
+}
+
+void QGVLayerPlayback::onTick()
+{
+    setTime(mClockOrigin + static_cast<qint64>(mClock.elapsed() * mRate));
+}
+
+void QGVLayerPlayback::rebuildIndex()
+{
+    mIndexDirty = false;
+    mStarts.resize(0);
+    mEnds.resize(0);
+    mTree.clear();
+    QVector<int> nonEmpty;
+    for (int index = 0; index < mFeatures.size(); ++index) {
+        const Feature& feature = mFeatures.at(index);
+        mStarts.append({ feature.from, index });
+        mEnds.append({ feature.to, index });
+        if (feature.from < feature.to) {
+            nonEmpty.append(index);
+        }
+    }
+    const auto byTime = [](const Boundary& left, const Boundary& right) { return left.time < right.time; };
+    std::sort(mStarts.begin(), mStarts.end(), byTime);
+    std::sort(mEnds.begin(), mEnds.end(), byTime);
+    mTreeRoot = buildTree(nonEmpty);
+}
+
+int QGVLayerPlayback::buildTree(QVector<int>& features)
+{
+    if (features.isEmpty()) {
+        return -1;
+    }
+    // Median start is a center inside at least one interval, so every node holds something
+    std::nth_element(features.begin(), features.begin() + features.size() / 2, features.end(), [this](int l, int r) {
+        return mFeatures.at(l).from < mFeatures.at(r).from;
+    });
+    const qint64 center = mFeatures.at(features.at(features.size() / 2)).from;
+
+    QVector<int> left;
+    QVector<int> right;
+    TreeNode node{ center, -1, -1, {}, {} };
+    for (int index : features) {
+        const Feature& feature = mFeatures.at(index);
+        if (feature.to <= center) {
+            left.append(index);
+        } else if (feature.from > center) {
+            right.append(index);
+        } else {
+            node.byStart.append(index);
+        }
+    }
+    features.clear();
+    node.byEnd = node.byStart;
+    std::sort(node.byStart.begin(), node.byStart.end(), [this](int l, int r) {
+        return mFeatures.at(l).from < mFeatures.at(r).from;
+    });
+    std::sort(node.byEnd.begin(), node.byEnd.end(), [this](int l, int r) {
+        return mFeatures.at(l).to > mFeatures.at(r).to;
+    });
+
+    const int nodeIndex = mTree.size();
+    mTree.append(node);
+    const int leftIndex = buildTree(left);
+    const int rightIndex = buildTree(right);
+    mTree[nodeIndex].left = leftIndex;
+    mTree[nodeIndex].right = rightIndex;
+    return nodeIndex;
+}
+
+void QGVLayerPlayback::queryTree(qint64 time, QVector<int>& result) const
+{
+    int nodeIndex = mTreeRoot;
+    while (nodeIndex != -1) {
+        const TreeNode& node = mTree.at(nodeIndex);
+        if (time < node.center) {
+            for (int index : node.byStart) {
+                if (mFeatures.at(index).from > time) {
+                    break;
+                }
+                result.append(index);
+            }
+            nodeIndex = node.left;
+        } else {
+            for (int index : node.byEnd) {
+                if (mFeatures.at(index).to <= time) {
+                    break;
+                }
+                result.append(index);
+            }
+            nodeIndex = node.right;
+        }
+    }
+}
+
+void QGVLayerPlayback::sweep(qint64 fromTime, qint64 toTime)
+{
+    const qint64 low = qMin(fromTime, toTime);
+    const qint64 high = qMax(fromTime, toTime);
+    const auto byTime = [](const Boundary& boundary, qint64 value) { return boundary.time <= value; };
+    for (const QVector<Boundary>* boundaries : { &mStarts, &mEnds }) {
+        auto iter = std::lower_bound(boundaries->begin(), boundaries->end(), low, byTime);
+        const auto end = std::lower_bound(boundaries->begin(), boundaries->end(), high, byTime);
+        for (; iter != end; ++iter) {
+            setActive(iter->feature, isActiveAt(mFeatures.at(iter->feature), toTime));
+        }
+    }
+}
+
+void QGVLayerPlayback::seek(qint64 time)
+{
+    QVector<int> result;
+    queryTree(time, result);
+    const QSet<int> oldActive = mActive;
+    for (int index : oldActive) {
+        if (!isActiveAt(mFeatures.at(index), time)) {
+            setActive(index, false);
+        }
+    }
+    for (int index : result) {
+        setActive(index, true);
+    }
+}
+
+void QGVLayerPlayback::setActive(int feature, bool active)
+{
+    if (active) {
+        if (mActive.contains(feature)) {
+            return;
+        }
+        mActive.insert(feature);
+    } else if (!mActive.remove(feature)) {
+        return;
+    }
+    setHidden(mFeatures.at(feature).item, !active);
+}
+
+void QGVLayerPlayback::setHidden(QGVItem* item, bool hidden)
+{
+    // Inactive features are auto-hidden, user visibility stays untouched
+    if (hidden) {
+        if (!mHidden.contains(item)) {
+            mHidden.insert(item);
+            item->setAutoHidden(true);
+        }
+    } else if (mHidden.remove(item)) {
+        item->setAutoHidden(false);
+    }
+}
+
+bool QGVLayerPlayback::isActiveAt(const Feature& feature, qint64 time) const
+{
+    return feature.from <= time && time < feature.to;
+}
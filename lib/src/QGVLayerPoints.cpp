@@ -0,0 +1,364 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "QGVLayerPoints.h"
+#include "QGVLayerPaintItem.h"
+
+#include <QPainter>
+#include <QtMath>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+const int pointsPerCell = 32;
+const int maxGridSide = 1024;
+}
+
+QGVLayerPoints::QGVLayerPoints()
+    : mItem(new QGVLayerPaintItem([this]() { return projBoundingRect(); },
+                                  [this](QPainter* painter) { projPaint(painter); }))
+    , mGridDirty(false)
+    , mGridSide(0)
+    , mPreparedProjection(nullptr)
+{
+    addItem(mItem);
+}
+
+int QGVLayerPoints::addStyle(const QColor& color, double pixelSize)
+{
+    Q_ASSERT(mStyles.size() <= std::numeric_limits<quint8>::max());
+    mStyles.append({ color, pixelSize });
+    mPaintBatches.resize(mStyles.size());
+    mHeadingBatches.resize(mStyles.size());
+    repaintPoints();
+    return mStyles.size() - 1;
+}
+
+int QGVLayerPoints::countStyles() const
+{
+    return mStyles.size();
+}
+
+void QGVLayerPoints::setPoints(const double* lats, const double* lons, const quint8* styles, int count)
+{
+    mGeoLat.resize(0);
+    mGeoLon.resize(0);
+    mProjX.resize(0);
+    mProjY.resize(0);
+    mHeading.resize(0);
+    mPointStyles.resize(0);
+    mProjRect = {};
+    appendPoints(lats, lons, styles, count);
+}
+
+int QGVLayerPoints::appendPoints(const double* lats, const double* lons, const quint8* styles, int count)
+{
+    Q_ASSERT(count >= 0);
+    Q_ASSERT(count == 0 || (lats != nullptr && lons != nullptr));
+    const int first = mGeoLat.size();
+    const int total = first + count;
+    mGeoLat.resize(total);
+    mGeoLon.resize(total);
+    mProjX.resize(total);
+    mProjY.resize(total);
+    mHeading.resize(total);
+    mPointStyles.resize(total);
+    std::copy(lats, lats + count, mGeoLat.begin() + first);
+    std::copy(lons, lons + count, mGeoLon.begin() + first);
+    if (styles != nullptr) {
+        std::copy(styles, styles + count, mPointStyles.begin() + first);
+    } else {
+        std::fill(mPointStyles.begin() + first, mPointStyles.end(), 0);
+    }
+    std::fill(mHeading.begin() + first, mHeading.end(), std::numeric_limits<double>::quiet_NaN());
+    projectPoints(first);
+    return first;
+}
+
+void QGVLayerPoints::updatePoints(const int* indices,
+                                  const double* lats,
+                                  const double* lons,
+                                  const double* headings,
+                                  int count)
+{
+    Q_ASSERT(count >= 0);
+    Q_ASSERT(count == 0 || (indices != nullptr && lats != nullptr && lons != nullptr));
+    if (count <= 0) {
+        return;
+    }
+
+    // Indices come from caller, out of range ones are skipped in release builds too
+    const int size = mGeoLat.size();
+    const auto isValid = [size](int index) { return index >= 0 && index < size; };
+    double* geoLat = mGeoLat.data();
+    double* geoLon = mGeoLon.data();
+    double* heading = mHeading.data();
+    int invalid = 0;
+    for (int k = 0; k < count; ++k) {
+        const int i = indices[k];
+        if (!isValid(i)) {
+            invalid++;
+            continue;
+        }
+        geoLat[i] = lats[k];
+        geoLon[i] = lons[k];
+        if (headings != nullptr) {
+            heading[i] = headings[k];
+        }
+    }
+    if (invalid > 0) {
+        qgvDebug() << "updatePoints skipped" << invalid << "invalid indices of" << count;
+    }
+    if (getMap() == nullptr || invalid == count) {
+        return;
+    }
+
+    // Dirty area covers both old and new positions, grid is rebuilt once on next paint
+    const QGVProjection* projection = getMap()->getProjection();
+    double* x = mProjX.data();
+    double* y = mProjY.data();
+    QVector<double> newX(count);
+    QVector<double> newY(count);
+    projection->geoToProj(lats, lons, newX.data(), newY.data(), count);
+    double minX = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double minY = minX;
+    double maxY = maxX;
+    for (int k = 0; k < count; ++k) {
+        const int i = indices[k];
+        if (!isValid(i)) {
+            continue;
+        }
+        minX = qMin(minX, qMin(x[i], newX[k]));
+        maxX = qMax(maxX, qMax(x[i], newX[k]));
+        minY = qMin(minY, qMin(y[i], newY[k]));
+        maxY = qMax(maxY, qMax(y[i], newY[k]));
+        x[i] = newX[k];
+        y[i] = newY[k];
+    }
+    mProjRect = QRectF(QPointF(qMin(minX, mProjRect.left()), qMin(minY, mProjRect.top())),
+                       QPointF(qMax(maxX, mProjRect.right()), qMax(maxY, mProjRect.bottom())));
+    mGridDirty = true;
+
+    const double margin = maxPixelExtent() / getMap()->getCamera().scale();
+    mItem->repaint(QRectF(QPointF(minX, minY), QPointF(maxX, maxY)).adjusted(-margin, -margin, margin, margin));
+}
+
+void QGVLayerPoints::clearPoints()
+{
+    setPoints(nullptr, nullptr, nullptr, 0);
+}
+
+int QGVLayerPoints::countPoints() const
+{
+    return mGeoLat.size();
+}
+
+void QGVLayerPoints::onProjectionPrepare(const QGVProjection* projection)
+{
+    calculateProjection(projection, 0);
+    mPreparedProjection = projection;
+}
+
+void QGVLayerPoints::onProjection(QGVMap* geoMap)
+{
+    QGVLayer::onProjection(geoMap);
+    mItem->resetBoundary();
+    if (mPreparedProjection == geoMap->getProjection()) {
+        mPreparedProjection = nullptr;
+        repaintPoints();
+        return;
+    }
+    projectPoints(0);
+}
+
+void QGVLayerPoints::projectPoints(int from)
+{
+    if (getMap() != nullptr) {
+        calculateProjection(getMap()->getProjection(), from);
+    }
+    mGridDirty = true;
+    repaintPoints();
+}
+
+void QGVLayerPoints::calculateProjection(const QGVProjection* projection, int from)
+{
+    mGridDirty = true;
+    const int count = mGeoLat.size();
+    if (from >= count) {
+        return;
+    }
+
+    const double* lat = mGeoLat.constData();
+    const double* lon = mGeoLon.constData();
+    double* x = mProjX.data();
+    double* y = mProjY.data();
+    projection->geoToProj(lat + from, lon + from, x + from, y + from, count - from);
+
+    double minX = (from > 0) ? mProjRect.left() : x[from];
+    double maxX = (from > 0) ? mProjRect.right() : x[from];
+    double minY = (from > 0) ? mProjRect.top() : y[from];
+    double maxY = (from > 0) ? mProjRect.bottom() : y[from];
+    for (int i = from; i < count; ++i) {
+        minX = qMin(minX, x[i]);
+        maxX = qMax(maxX, x[i]);
+        minY = qMin(minY, y[i]);
+        maxY = qMax(maxY, y[i]);
+    }
+    mProjRect = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+}
+
+void QGVLayerPoints::updateGrid()
+{
+    if (!mGridDirty) {
+        return;
+    }
+    mGridDirty = false;
+
+    const int count = mProjX.size();
+    mGridSide = qBound(1, static_cast<int>(qSqrt(count / pointsPerCell)), maxGridSide);
+    mGridRect = mProjRect;
+
+    const double left = mGridRect.left();
+    const double top = mGridRect.top();
+    const double kx = (mGridRect.width() > 0) ? mGridSide / mGridRect.width() : 0.0;
+    const double ky = (mGridRect.height() > 0) ? mGridSide / mGridRect.height() : 0.0;
+    const int side = mGridSide;
+    const double* x = mProjX.constData();
+    const double* y = mProjY.constData();
+    const auto cellOf = [=](int i) -> int {
+        const int col = qMin(side - 1, static_cast<int>((x[i] - left) * kx));
+        const int row = qMin(side - 1, static_cast<int>((y[i] - top) * ky));
+        return row * side + col;
+    };
+
+    mCellStart.fill(0, side * side + 1);
+    int* cellStart = mCellStart.data();
+    for (int i = 0; i < count; ++i) {
+        cellStart[cellOf(i) + 1]++;
+    }
+    for (int cell = 1; cell <= side * side; ++cell) {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+    QVector<int> cursor = mCellStart;
+    int* cellCursor = cursor.data();
+    mCellPoints.resize(count);
+    int* cellPoints = mCellPoints.data();
+    for (int i = 0; i < count; ++i) {
+        cellPoints[cellCursor[cellOf(i)]++] = i;
+    }
+}
+
+void QGVLayerPoints::repaintPoints()
+{
+    mItem->repaint();
+}
+
+double QGVLayerPoints::maxPixelExtent() const
+{
+    double maxSize = 0;
+    for (const Style& style : mStyles) {
+        maxSize = qMax(maxSize, style.size);
+    }
+    return 2 * maxSize;
+}
+
+QRectF QGVLayerPoints::projBoundingRect() const
+{
+    if (getMap() == nullptr) {
+        return {};
+    }
+    return getMap()->getProjection()->boundaryProjRect();
+}
+
+void QGVLayerPoints::projPaint(QPainter* painter)
+{
+    if (mProjX.isEmpty() || mStyles.isEmpty()) {
+        return;
+    }
+    updateGrid();
+
+    const QGVCameraState camera = getMap()->getCamera();
+    const double margin = maxPixelExtent() / camera.scale();
+    const QRectF area = camera.projRect().adjusted(-margin, -margin, margin, margin);
+
+    const int side = mGridSide;
+    const double kx = (mGridRect.width() > 0) ? side / mGridRect.width() : 0.0;
+    const double ky = (mGridRect.height() > 0) ? side / mGridRect.height() : 0.0;
+    const int col0 = qBound(0, qFloor((area.left() - mGridRect.left()) * kx), side - 1);
+    const int col1 = qBound(0, qFloor((area.right() - mGridRect.left()) * kx), side - 1);
+    const int row0 = qBound(0, qFloor((area.top() - mGridRect.top()) * ky), side - 1);
+    const int row1 = qBound(0, qFloor((area.bottom() - mGridRect.top()) * ky), side - 1);
+
+    for (QVector<QPointF>& batch : mPaintBatches) {
+        batch.resize(0);
+    }
+    for (QVector<QLineF>& batch : mHeadingBatches) {
+        batch.resize(0);
+    }
+    const double headingFactor = 2.0 / camera.scale();
+    const double* heading = mHeading.constData();
+    const double* x = mProjX.constData();
+    const double* y = mProjY.constData();
+    const quint8* styles = mPointStyles.constData();
+    const int* cellStart = mCellStart.constData();
+    const int* cellPoints = mCellPoints.constData();
+    const int stylesCount = mStyles.size();
+    for (int row = row0; row <= row1; ++row) {
+        for (int col = col0; col <= col1; ++col) {
+            const int cell = row * side + col;
+            for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                const int i = cellPoints[k];
+                if (x[i] < area.left() || x[i] > area.right() || y[i] < area.top() || y[i] > area.bottom()) {
+                    continue;
+                }
+                if (styles[i] >= stylesCount) {
+                    continue;
+                }
+                const QPointF projPos(x[i], y[i]);
+                mPaintBatches[styles[i]].append(projPos);
+                if (!qIsNaN(heading[i])) {
+                    const double length = mStyles.at(styles[i]).size * headingFactor;
+                    const double radians = qDegreesToRadians(heading[i]);
+                    mHeadingBatches[styles[i]].append(
+                            QLineF(projPos, projPos + QPointF(qSin(radians), -qCos(radians)) * length));
+                }
+            }
+        }
+    }
+
+    for (int index = 0; index < stylesCount; ++index) {
+        const QVector<QPointF>& batch = mPaintBatches.at(index);
+        if (batch.isEmpty()) {
+            continue;
+        }
+        const Style& style = mStyles.at(index);
+        QPen pen(QBrush(style.color), style.size, Qt::SolidLine, Qt::RoundCap);
+        pen.setCosmetic(true);
+        painter->setPen(pen);
+        painter->drawPoints(batch.constData(), batch.size());
+
+        const QVector<QLineF>& headingBatch = mHeadingBatches.at(index);
+        if (!headingBatch.isEmpty()) {
+            pen.setWidthF(qMax(1.0, style.size / 3));
+            painter->setPen(pen);
+            painter->drawLines(headingBatch.constData(), headingBatch.size());
+        }
+    }
+}
@@ -0,0 +1,498 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "QGVLayerRaster.h"
+#include "Raster/QGVImage.h"
+
+#include <QCache>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageIOHandler>
+#include <QImageReader>
+#include <QMutex>
+#include <QPainter>
+#include <QPointer>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSet>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtMath>
+
+#include <cmath>
+
+namespace {
+const int tileSize = 256;
+const int blockSize = 512;
+const int maxRasterZoom = 22;
+const int blockCacheKb = 256 * 1024;
+QAtomicInt sourceCounter;
+}
+
+class QGVLayerRasterSource
+{
+public:
+    QGVLayerRasterSource(const QString& fileName, bool persistent)
+        : mFileName(fileName)
+        , mPersistent(persistent)
+    {
+        QImageReader reader(mFileName);
+        mSize = reader.size();
+        mSupportsClip = reader.supportsOption(QImageIOHandler::ClipRect);
+        mLevels = 1;
+        while (levelSize(mLevels - 1).width() > blockSize || levelSize(mLevels - 1).height() > blockSize) {
+            mLevels++;
+        }
+
+        // Pyramid lives next to the source when persistent, in temp folder otherwise.
+        // Stamp of source size and time keeps replaced sources from serving stale blocks.
+        const QFileInfo info(mFileName);
+        const QString source = QString("%1|%2|%3")
+                                       .arg(info.absoluteFilePath())
+                                       .arg(info.size())
+                                       .arg(info.lastModified().toMSecsSinceEpoch());
+        const QByteArray hash = QCryptographicHash::hash(source.toUtf8(), QCryptographicHash::Md5);
+        const QString stamp = QString::fromLatin1(hash.toHex());
+        if (mPersistent) {
+            const QString pyramidDir = info.absolutePath() + "/" + info.fileName() + ".pyramid";
+            for (const QString& stale : QDir(pyramidDir).entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+                if (stale != stamp) {
+                    QDir(pyramidDir + "/" + stale).removeRecursively();
+                }
+            }
+            mCacheDir = pyramidDir + "/" + stamp;
+        } else {
+            // Temp pyramid is private to this source instance, so removal cannot affect other layers
+            mCacheDir = QDir::temp().absoluteFilePath(QString("qgv-raster-%1-%2-%3")
+                                                              .arg(stamp)
+                                                              .arg(QCoreApplication::applicationPid())
+                                                              .arg(sourceCounter.fetchAndAddRelaxed(1)));
+        }
+        mBlocks.setMaxCost(blockCacheKb);
+    }
+
+    ~QGVLayerRasterSource()
+    {
+        if (!mPersistent) {
+            QDir(mCacheDir).removeRecursively();
+        }
+    }
+
+    QSize size() const
+    {
+        return mSize;
+    }
+
+    int levels() const
+    {
+        return mLevels;
+    }
+
+    QSize levelSize(int level) const
+    {
+        const int factor = 1 << level;
+        return QSize((mSize.width() + factor - 1) / factor, (mSize.height() + factor - 1) / factor);
+    }
+
+    QImage block(int level, int blockX, int blockY)
+    {
+        const QString key = QString("%1/%2_%3").arg(level).arg(blockX).arg(blockY);
+        {
+            // Only one worker builds a block, others wait for its result
+            QMutexLocker locker(&mMutex);
+            for (;;) {
+                const QImage* cached = mBlocks.object(key);
+                if (cached != nullptr) {
+                    return *cached;
+                }
+                if (!mBuilding.contains(key)) {
+                    break;
+                }
+                mBuilt.wait(&mMutex);
+            }
+            mBuilding.insert(key);
+        }
+
+        const QString path = mCacheDir + "/" + key + ".png";
+        QImage image;
+        if (QFile::exists(path)) {
+            image.load(path);
+        }
+        if (image.isNull()) {
+            image = (level == 0) ? readBlock(blockX, blockY) : downscaleBlock(level, blockX, blockY);
+            storeBlock(path, image);
+        }
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+        QMutexLocker locker(&mMutex);
+        mBlocks.insert(key, new QImage(image), qMax(1, static_cast<int>(image.sizeInBytes() / 1024)));
+        mBuilding.remove(key);
+        mBuilt.wakeAll();
+        return image;
+    }
+
+private:
+    QRect blockRect(int level, int blockX, int blockY) const
+    {
+        const QRect levelRect(QPoint(0, 0), levelSize(level));
+        return QRect(blockX * blockSize, blockY * blockSize, blockSize, blockSize).intersected(levelRect);
+    }
+
+    QImage readBlock(int blockX, int blockY)
+    {
+        const QRect rect = blockRect(0, blockX, blockY);
+        if (mSupportsClip) {
+            QImageReader reader(mFileName);
+            reader.setClipRect(rect);
+            return reader.read();
+        }
+
+        // Without clip support source is decoded only once and split into level 0 blocks
+        QMutexLocker locker(&mDecodeMutex);
+        const QString path = QString("%1/0/%2_%3.png").arg(mCacheDir).arg(blockX).arg(blockY);
+        QImage image;
+        if (QFile::exists(path) && image.load(path)) {
+            return image;
+        }
+        qgvDebug() << "full decode of raster" << mFileName;
+        const QImage source = QImageReader(mFileName).read();
+        const QSize blocks = blockCount(0);
+        for (int y = 0; y < blocks.height(); ++y) {
+            for (int x = 0; x < blocks.width(); ++x) {
+                const QImage part = source.copy(blockRect(0, x, y));
+                storeBlock(QString("%1/0/%2_%3.png").arg(mCacheDir).arg(x).arg(y), part);
+                if (x == blockX && y == blockY) {
+                    image = part;
+                }
+            }
+        }
+        return image;
+    }
+
+    QImage downscaleBlock(int level, int blockX, int blockY)
+    {
+        const QRect rect = blockRect(level, blockX, blockY);
+        QImage image(rect.size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        const QSize children = blockCount(level - 1);
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.scale(0.5, 0.5);
+        for (int y = 0; y < 2; ++y) {
+            for (int x = 0; x < 2; ++x) {
+                const int childX = blockX * 2 + x;
+                const int childY = blockY * 2 + y;
+                if (childX >= children.width() || childY >= children.height()) {
+                    continue;
+                }
+                painter.drawImage(QPoint(x * blockSize, y * blockSize), block(level - 1, childX, childY));
+            }
+        }
+        painter.end();
+        return image;
+    }
+
+    QSize blockCount(int level) const
+    {
+        const QSize size = levelSize(level);
+        return QSize((size.width() + blockSize - 1) / blockSize, (size.height() + blockSize - 1) / blockSize);
+    }
+
+    void storeBlock(const QString& path, const QImage& image) const
+    {
+        if (image.isNull()) {
+            return;
+        }
+        // Unique temp file with atomic commit, readers never see partial PNG
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QSaveFile file(path);
+        if (file.open(QIODevice::WriteOnly) && image.save(&file, "PNG")) {
+            file.commit();
+        }
+    }
+
+private:
+    QString mFileName;
+    bool mPersistent;
+    QString mCacheDir;
+    QSize mSize;
+    bool mSupportsClip;
+    int mLevels;
+    QMutex mMutex;
+    QMutex mDecodeMutex;
+    QWaitCondition mBuilt;
+    QSet<QString> mBuilding;
+    QCache<QString, QImage> mBlocks;
+};
+
+class QGVLayerRasterTask : public QRunnable
+{
+public:
+    QGVLayerRasterTask(QGVLayerRaster* layer,
+                       const QSharedPointer<QGVLayerRasterSource>& source,
+                       const QGV::GeoTilePos& tilePos,
+                       const QRectF& sourceRect,
+                       const QRectF& targetRect,
+                       const QSharedPointer<QAtomicInt>& token)
+        : mLayer(layer)
+        , mSource(source)
+        , mTilePos(tilePos)
+        , mSourceRect(sourceRect)
+        , mTargetRect(targetRect)
+        , mToken(token)
+    {
+    }
+
+    void run() override
+    {
+        if (mToken->loadAcquire() != 0) {
+            return;
+        }
+        const QImage image = render();
+        if (mToken->loadAcquire() != 0) {
+            return;
+        }
+        // Layer may be gone already, it is checked only on GUI thread
+        QCoreApplication* app = QCoreApplication::instance();
+        if (app == nullptr) {
+            return;
+        }
+        const QPointer<QGVLayerRaster> layer = mLayer;
+        const QGV::GeoTilePos tilePos = mTilePos;
+        const QSharedPointer<QAtomicInt> token = mToken;
+        QMetaObject::invokeMethod(
+                app,
+                [layer, tilePos, token, image]() {
+                    if (!layer.isNull()) {
+                        layer->onTileRendered(tilePos, token, image);
+                    }
+                },
+                Qt::QueuedConnection);
+    }
+
+private:
+    QImage render() const
+    {
+        // Pyramid level with about one source pixel per tile pixel
+        const double ratio = mSourceRect.width() / mTargetRect.width();
+        const int level = qBound(0, qFloor(std::log2(qMax(1.0, ratio))), mSource->levels() - 1);
+        const double levelFactor = std::ldexp(1.0, -level);
+        const QRectF levelRect(mSourceRect.topLeft() * levelFactor, mSourceRect.size() * levelFactor);
+
+        QImage image(tileSize, tileSize, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.setClipRect(mTargetRect);
+        painter.translate(mTargetRect.topLeft());
+        painter.scale(mTargetRect.width() / levelRect.width(), mTargetRect.height() / levelRect.height());
+        painter.translate(-levelRect.topLeft());
+
+        const int fromX = qMax(0, qFloor(levelRect.left() / blockSize));
+        const int toX = qFloor((levelRect.right() - 1e-9) / blockSize);
+        const int fromY = qMax(0, qFloor(levelRect.top() / blockSize));
+        const int toY = qFloor((levelRect.bottom() - 1e-9) / blockSize);
+        for (int blockY = fromY; blockY <= toY; ++blockY) {
+            for (int blockX = fromX; blockX <= toX; ++blockX) {
+                if (mToken->loadAcquire() != 0) {
+                    return {};
+                }
+                painter.drawImage(QPoint(blockX * blockSize, blockY * blockSize),
+                                  mSource->block(level, blockX, blockY));
+            }
+        }
+        painter.end();
+        return image;
+    }
+
+private:
+    QPointer<QGVLayerRaster> mLayer;
+    QSharedPointer<QGVLayerRasterSource> mSource;
+    QGV::GeoTilePos mTilePos;
+    QRectF mSourceRect;
+    QRectF mTargetRect;
+    QSharedPointer<QAtomicInt> mToken;
+};
+
+QGVLayerRaster::QGVLayerRaster()
+    : mPersistentCache(false)
+    , mMaxZoom(0)
+{
+}
+
+QGVLayerRaster::~QGVLayerRaster()
+{
+    // Running tasks keep their source alive and drop results of deleted layer
+    for (const auto& token : mRequests) {
+        token->storeRelease(1);
+    }
+}
+
+void QGVLayerRaster::setSource(const QString& fileName, const QGV::GeoRect& geoRect)
+{
+    mFileName = fileName;
+    mGeoRect = geoRect;
+    resetTiles();
+}
+
+QString QGVLayerRaster::getSource() const
+{
+    return mFileName;
+}
+
+QGV::GeoRect QGVLayerRaster::getGeoRect() const
+{
+    return mGeoRect;
+}
+
+QSize QGVLayerRaster::getSourceSize() const
+{
+    return (mSource.isNull()) ? QSize() : mSource->size();
+}
+
+void QGVLayerRaster::setPersistentCache(bool enabled)
+{
+    if (mPersistentCache == enabled) {
+        return;
+    }
+    mPersistentCache = enabled;
+    resetTiles();
+}
+
+bool QGVLayerRaster::isPersistentCache() const
+{
+    return mPersistentCache;
+}
+
+void QGVLayerRaster::onProjection(QGVMap* geoMap)
+{
+    QGVLayerTiles::onProjection(geoMap);
+    calculateGeometry();
+}
+
+int QGVLayerRaster::minZoomlevel() const
+{
+    return 0;
+}
+
+int QGVLayerRaster::maxZoomlevel() const
+{
+    return mMaxZoom;
+}
+
+void QGVLayerRaster::request(const QGV::GeoTilePos& tilePos)
+{
+    const auto token = QSharedPointer<QAtomicInt>::create(0);
+    mRequests[tilePos] = token;
+
+    // Projection is used only here on GUI thread, workers get plain pixel rects
+    QRectF sourceRect;
+    QRectF targetRect;
+    if (!mSource.isNull() && !mProjRect.isEmpty()) {
+        const QRectF tileProjRect = getMap()->getProjection()->geoToProj(tilePos.toGeoRect());
+        const QRectF overlap = tileProjRect.intersected(mProjRect);
+        if (!overlap.isEmpty()) {
+            const QSize size = mSource->size();
+            sourceRect = QRectF((overlap.left() - mProjRect.left()) / mProjRect.width() * size.width(),
+                                (overlap.top() - mProjRect.top()) / mProjRect.height() * size.height(),
+                                overlap.width() / mProjRect.width() * size.width(),
+                                overlap.height() / mProjRect.height() * size.height());
+            targetRect = QRectF((overlap.left() - tileProjRect.left()) / tileProjRect.width() * tileSize,
+                                (overlap.top() - tileProjRect.top()) / tileProjRect.height() * tileSize,
+                                overlap.width() / tileProjRect.width() * tileSize,
+                                overlap.height() / tileProjRect.height() * tileSize);
+        }
+    }
+    if (sourceRect.isEmpty() || targetRect.isEmpty()) {
+        QMetaObject::invokeMethod(
+                this, [this, tilePos, token]() { onTileRendered(tilePos, token, QImage()); }, Qt::QueuedConnection);
+        return;
+    }
+    auto task = new QGVLayerRasterTask(this, mSource, tilePos, sourceRect, targetRect, token);
+    QThreadPool::globalInstance()->start(task);
+}
+
+void QGVLayerRaster::cancel(const QGV::GeoTilePos& tilePos)
+{
+    const auto token = mRequests.take(tilePos);
+    if (!token.isNull()) {
+        token->storeRelease(1);
+    }
+}
+
+void QGVLayerRaster::calculateGeometry()
+{
+    mProjRect = {};
+    mMaxZoom = 0;
+    if (getMap() == nullptr || mSource.isNull() || mSource->size().isEmpty()) {
+        return;
+    }
+    const QGVProjection* projection = getMap()->getProjection();
+    mProjRect = projection->geoToProj(mGeoRect);
+
+    // Deepest zoom shows source pixels at about one to one
+    const double worldWidth = projection->boundaryProjRect().width();
+    const double sourcePixels = worldWidth / mProjRect.width() * mSource->size().width();
+    mMaxZoom = qBound(0, qCeil(std::log2(sourcePixels / tileSize)), maxRasterZoom);
+    qgvDebug() << "raster" << mFileName << mSource->size() << "max zoom" << mMaxZoom;
+}
+
+void QGVLayerRaster::resetTiles()
+{
+    for (const auto& token : mRequests) {
+        token->storeRelease(1);
+    }
+    mRequests.clear();
+    mSource.reset();
+    if (!mFileName.isEmpty()) {
+        mSource = QSharedPointer<QGVLayerRasterSource>::create(mFileName, mPersistentCache);
+    }
+    calculateGeometry();
+    if (getMap() != nullptr) {
+        QGVLayerTiles::onClean();
+        update();
+    }
+}
+
+void QGVLayerRaster::onTileRendered(const QGV::GeoTilePos& tilePos,
+                                    const QSharedPointer<QAtomicInt>& token,
+                                    const QImage& image)
+{
+    const auto iter = mRequests.find(tilePos);
+    if (iter == mRequests.end() || iter.value() != token) {
+        return;
+    }
+    mRequests.erase(iter);
+
+    auto tile = new QGVImage();
+    tile->setGeometry(tilePos.toGeoRect());
+    if (!image.isNull()) {
+        tile->loadImage(image);
+    }
+    tile->setProperty("drawDebug",
+                      QString("%1\ntile(%2,%3,%4)")
+                              .arg(mFileName)
+                              .arg(tilePos.zoom())
+                              .arg(tilePos.pos().x())
+                              .arg(tilePos.pos().y()));
+    onTile(tilePos, tile);
+}
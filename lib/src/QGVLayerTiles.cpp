@@ -18,12 +18,14 @@
 
 #include "QGVLayerTiles.h"
 #include "QGVDrawItem.h"
+#include "QGVFrameScheduler.h"
 
 #include <QtMath>
 
 QGVLayerTiles::QGVLayerTiles()
 {
     mCurZoom = -1;
+    setCameraDependent(true);
     sendToBack();
 }
 
@@ -93,13 +95,17 @@ void QGVLayerTiles::onCamera(const QGVCameraState& oldState, const QGVCameraStat
     }
 
     if (needUpdate) {
-        processCamera();
+        // Camera changes within one frame are handled once at frame time
+        getMap()->frameScheduler()->schedule(this, [this]() { processCamera(); });
     }
 }
 
 void QGVLayerTiles::onUpdate()
 {
     QGVLayer::onUpdate();
+    if (getMap() != nullptr) {
+        getMap()->frameScheduler()->cancel(this);
+    }
     processCamera();
 }
 
@@ -114,7 +120,7 @@ void QGVLayerTiles::onClean()
 
 void QGVLayerTiles::onTile(const QGV::GeoTilePos& tilePos, QGVDrawItem* tileObj)
 {
-    if (tilePos.zoom() != mCurZoom || !mCurRect.contains(tilePos.pos())) {
+    if (tilePos.zoom() != mCurZoom || !isTileInView(tilePos)) {
         delete tileObj;
         return;
     }
@@ -135,9 +141,7 @@ void QGVLayerTiles::onTile(const QGV::GeoTilePos& tilePos, QGVDrawItem* tileObj)
 
 int QGVLayerTiles::scaleToZoom(double scale) const
 {
-    const double scaleChange = 1 / scale;
-    const int newZoom = qRound((17.0 - qLn(scaleChange) * M_LOG2E));
-    return newZoom;
+    return QGV::scaleToZoom(scale);
 }
 
 void QGVLayerTiles::processCamera()
@@ -161,13 +165,25 @@ void QGVLayerTiles::processCamera()
 
     const int margin = (zoomChanged) ? static_cast<int>(mPerfomanceProfile.TilesMarginWithZoomChange)
                                      : static_cast<int>(mPerfomanceProfile.TilesMarginNoZoomChange);
-    const int sizePerZoom = static_cast<int>(qPow(2, mCurZoom));
+    const int sizePerZoom = 1 << mCurZoom;
     const QRect maxRect = QRect(QPoint(0, 0), QPoint(sizePerZoom, sizePerZoom));
-    const QPoint topLeft = QGV::GeoTilePos::geoToTilePos(mCurZoom, areaGeoRect.topLeft()).pos();
-    const QPoint bottomRight = QGV::GeoTilePos::geoToTilePos(mCurZoom, areaGeoRect.bottomRight()).pos();
+    QPoint topLeft = QGV::GeoTilePos::geoToTilePos(mCurZoom, areaGeoRect.topLeft()).pos();
+    QPoint bottomRight = QGV::GeoTilePos::geoToTilePos(mCurZoom, areaGeoRect.bottomRight()).pos();
+    if (getMap()->isWorldWrap()) {
+        // Columns go beyond world edges and are wrapped modulo zoom size on request
+        const QRectF worldRect = projection->boundaryProjRect();
+        const QRectF cameraRect = camera.projRect();
+        topLeft.setX(qFloor((cameraRect.left() - worldRect.left()) / worldRect.width() * sizePerZoom));
+        bottomRight.setX(qFloor((cameraRect.right() - worldRect.left()) / worldRect.width() * sizePerZoom));
+    }
     QRect activeRect = QRect(topLeft, bottomRight);
     activeRect = activeRect.adjusted(-margin, -margin, margin, margin);
-    activeRect = activeRect.intersected(maxRect);
+    if (getMap()->isWorldWrap()) {
+        const int right = qMin(activeRect.right(), activeRect.left() + sizePerZoom);
+        activeRect = activeRect.intersected(QRect(QPoint(activeRect.left(), 0), QPoint(right, sizePerZoom)));
+    } else {
+        activeRect = activeRect.intersected(maxRect);
+    }
     const bool rectChanged = (!zoomChanged && (mCurRect != activeRect));
     mCurRect = activeRect;
 
@@ -201,7 +217,7 @@ void QGVLayerTiles::processCamera()
     if (rectChanged) {
         qgvDebug() << "new active rect" << mCurRect.topLeft() << mCurRect.bottomRight();
         for (const QGV::GeoTilePos& tilePos : existingTiles(mCurZoom)) {
-            if (!mCurRect.contains(tilePos.pos())) {
+            if (!isTileInView(tilePos)) {
                 qgvDebug() << "delete out of boundary view" << tilePos;
                 removeTile(tilePos);
             }
@@ -211,11 +227,14 @@ void QGVLayerTiles::processCamera()
     QMultiMap<qreal, QGV::GeoTilePos> missing;
     for (int x = mCurRect.left(); x < mCurRect.right(); ++x) {
         for (int y = mCurRect.top(); y < mCurRect.bottom(); ++y) {
-            const auto tilePos = QGV::GeoTilePos(mCurZoom, QPoint(x, y));
+            const int wrappedX = ((x % sizePerZoom) + sizePerZoom) % sizePerZoom;
+            const auto tilePos = QGV::GeoTilePos(mCurZoom, QPoint(wrappedX, y));
             if (isTileExists(tilePos)) {
                 continue;
             }
-            qreal radius = qSqrt(qPow(x - mCurRect.center().x(), 2) + qPow(y - mCurRect.center().y(), 2));
+            const int dx = x - mCurRect.center().x();
+            const int dy = y - mCurRect.center().y();
+            const qreal radius = qSqrt(dx * dx + dy * dy);
             missing.insert(radius, tilePos);
         }
     }
@@ -243,7 +262,7 @@ void QGVLayerTiles::removeAllAbove(const QGV::GeoTilePos& tilePos)
 void QGVLayerTiles::removeWhenCovered(const QGV::GeoTilePos& tilePos)
 {
     const int zoomDelta = mCurZoom - tilePos.zoom() + 1;
-    const int neededCount = static_cast<int>(qPow(2, zoomDelta));
+    const int neededCount = 1 << zoomDelta;
     int count = neededCount;
     for (const QGV::GeoTilePos& current : existingTiles(mCurZoom)) {
         if (!tilePos.contains(current)) {
@@ -308,18 +327,35 @@ void QGVLayerTiles::removeTile(const QGV::GeoTilePos& tilePos)
 
 bool QGVLayerTiles::isTileExists(const QGV::GeoTilePos& tilePos) const
 {
-    return mIndex[tilePos.zoom()].contains(tilePos);
+    const auto zoomIter = mIndex.constFind(tilePos.zoom());
+    return zoomIter != mIndex.constEnd() && zoomIter->contains(tilePos);
 }
 
 bool QGVLayerTiles::isTileFinished(const QGV::GeoTilePos& tilePos) const
 {
-    if (!isTileExists(tilePos)) {
+    const auto zoomIter = mIndex.constFind(tilePos.zoom());
+    return zoomIter != mIndex.constEnd() && zoomIter->value(tilePos, nullptr) != nullptr;
+}
+
+bool QGVLayerTiles::isTileInView(const QGV::GeoTilePos& tilePos) const
+{
+    if (mCurRect.contains(tilePos.pos())) {
+        return true;
+    }
+    if (getMap() == nullptr || !getMap()->isWorldWrap()) {
         return false;
     }
-    return mIndex[tilePos.zoom()][tilePos] != nullptr;
+    const int sizePerZoom = 1 << tilePos.zoom();
+    const int shift = qFloor(static_cast<double>(mCurRect.left()) / sizePerZoom) * sizePerZoom;
+    for (int x = tilePos.pos().x() + shift; x <= mCurRect.right(); x += sizePerZoom) {
+        if (mCurRect.contains(QPoint(x, tilePos.pos().y()))) {
+            return true;
+        }
+    }
+    return false;
 }
 
 QList<QGV::GeoTilePos> QGVLayerTiles::existingTiles(int zoom) const
 {
-    return mIndex[zoom].keys();
+    return mIndex.value(zoom).keys();
 }
@@ -17,11 +17,88 @@
  ****************************************************************************/
 
 #include "QGVLayerTilesOnline.h"
+#include "QGVProjectionEPSG3857.h"
+#include "QGVProjectionEPSG4326.h"
 #include "Raster/QGVImage.h"
+#include "Raster/QGVRasterWarp.h"
+
+#include <QBuffer>
+#include <QImageReader>
+#include <QRunnable>
+
+namespace {
+const QGVProjection* tileProjectionById(QGV::Projection id)
+{
+    static const QGVProjectionEPSG3857 epsg3857;
+    static const QGVProjectionEPSG4326 epsg4326;
+    switch (id) {
+        case QGV::Projection::EPSG3857:
+            return &epsg3857;
+        case QGV::Projection::EPSG4326:
+            return &epsg4326;
+    }
+    return &epsg3857;
+}
+}
+
+class QGVLayerTilesOnlineWarpTask : public QRunnable
+{
+public:
+    QGVLayerTilesOnlineWarpTask(QGVLayerTilesOnline* layer,
+                                const QGV::GeoTilePos& tilePos,
+                                const QByteArray& rawImage,
+                                const QGVRasterWarp& warp,
+                                const QString& url,
+                                const QSharedPointer<QAtomicInt>& token)
+        : mLayer(layer)
+        , mTilePos(tilePos)
+        , mRawImage(rawImage)
+        , mWarp(warp)
+        , mUrl(url)
+        , mToken(token)
+    {
+    }
+
+    void run() override
+    {
+        if (mToken->loadAcquire() != 0) {
+            return;
+        }
+        const QImage image = mWarp.warp(QImage::fromData(mRawImage));
+        if (mToken->loadAcquire() != 0) {
+            return;
+        }
+        QGVLayerTilesOnline* layer = mLayer;
+        const QGV::GeoTilePos tilePos = mTilePos;
+        const QSharedPointer<QAtomicInt> token = mToken;
+        const QString url = mUrl;
+        QMetaObject::invokeMethod(
+                layer, [layer, tilePos, token, image, url]() { layer->onTileWarped(tilePos, token, image, url); },
+                Qt::QueuedConnection);
+    }
+
+private:
+    QGVLayerTilesOnline* mLayer;
+    QGV::GeoTilePos mTilePos;
+    QByteArray mRawImage;
+    QGVRasterWarp mWarp;
+    QString mUrl;
+    QSharedPointer<QAtomicInt> mToken;
+};
 
 QGVLayerTilesOnline::~QGVLayerTilesOnline()
 {
     qDeleteAll(mRequest);
+    for (const auto& token : mWarps) {
+        token->storeRelease(1);
+    }
+    mWarpPool.clear();
+    mWarpPool.waitForDone();
+}
+
+QGV::Projection QGVLayerTilesOnline::tileProjection() const
+{
+    return QGV::Projection::EPSG3857;
 }
 
 void QGVLayerTilesOnline::request(const QGV::GeoTilePos& tilePos)
@@ -53,6 +130,10 @@ void QGVLayerTilesOnline::request(const QGV::GeoTilePos& tilePos)
 void QGVLayerTilesOnline::cancel(const QGV::GeoTilePos& tilePos)
 {
     removeReply(tilePos);
+    const auto token = mWarps.take(tilePos);
+    if (!token.isNull()) {
+        token->storeRelease(1);
+    }
 }
 
 void QGVLayerTilesOnline::onReplyFinished(QNetworkReply* reply, const QGV::GeoTilePos& tilePos)
@@ -65,16 +146,55 @@ void QGVLayerTilesOnline::onReplyFinished(QNetworkReply* reply, const QGV::GeoTi
         return;
     }
     const auto rawImage = reply->readAll();
+    const QString url = reply->url().toString();
+    removeReply(tilePos);
+
+    // Tiles in other projection are warped on workers, lookup tables are built here from image header
+    const QGVProjection* source = tileProjectionById(tileProjection());
+    const QGVProjection* target = getMap()->getProjection();
+    if (source->getID() != target->getID()) {
+        QBuffer buffer;
+        buffer.setData(rawImage);
+        const QSize size = QImageReader(&buffer).size();
+        const QGVRasterWarp warp(source, target, tilePos.toGeoRect(), size);
+        if (!warp.isIdentity()) {
+            const auto token = QSharedPointer<QAtomicInt>::create(0);
+            mWarps[tilePos] = token;
+            mWarpPool.start(new QGVLayerTilesOnlineWarpTask(this, tilePos, rawImage, warp, url, token));
+            return;
+        }
+    }
+
     auto tile = new QGVImage();
-    tile->setGeometry(tilePos.toGeoRect());
     tile->loadImage(rawImage);
+    addTile(tilePos, tile, url);
+}
+
+void QGVLayerTilesOnline::onTileWarped(const QGV::GeoTilePos& tilePos,
+                                       const QSharedPointer<QAtomicInt>& token,
+                                       const QImage& image,
+                                       const QString& url)
+{
+    const auto iter = mWarps.find(tilePos);
+    if (iter == mWarps.end() || iter.value() != token) {
+        return;
+    }
+    mWarps.erase(iter);
+
+    auto tile = new QGVImage();
+    tile->loadImage(image);
+    addTile(tilePos, tile, url);
+}
+
+void QGVLayerTilesOnline::addTile(const QGV::GeoTilePos& tilePos, QGVImage* tile, const QString& url)
+{
+    tile->setGeometry(tilePos.toGeoRect());
     tile->setProperty("drawDebug",
                       QString("%1\ntile(%2,%3,%4)")
-                              .arg(reply->url().toString())
+                              .arg(url)
                               .arg(tilePos.zoom())
                               .arg(tilePos.pos().x())
                               .arg(tilePos.pos().y()));
-    removeReply(tilePos);
     onTile(tilePos, tile);
 }
 
@@ -0,0 +1,288 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "QGVLayerTrails.h"
+#include "QGVLayerPaintItem.h"
+
+#include <QPainter>
+
+namespace {
+const double decimationPixels = 2.0;
+
+bool isSegmentInArea(const QRectF& area, const QPointF& segStart, const QPointF& segEnd)
+{
+    // Closed bounds check, horizontal and vertical segments have zero-area bounds
+    return qMax(segStart.x(), segEnd.x()) >= area.left() && qMin(segStart.x(), segEnd.x()) <= area.right() &&
+           qMax(segStart.y(), segEnd.y()) >= area.top() && qMin(segStart.y(), segEnd.y()) <= area.bottom();
+}
+}
+
+QGVLayerTrails::QGVLayerTrails()
+    : mItem(new QGVLayerPaintItem([this]() { return projBoundingRect(); },
+                                  [this](QPainter* painter) { projPaint(painter); }))
+    , mCapacity(256)
+    , mMaxAge(0)
+    , mPen(QBrush(Qt::darkGray), 2)
+    , mPreparedProjection(nullptr)
+{
+    mPen.setCosmetic(true);
+    mPen.setCapStyle(Qt::RoundCap);
+    addItem(mItem);
+}
+
+void QGVLayerTrails::setCapacity(int points)
+{
+    mCapacity = qMax(2, points);
+    for (Track& track : mTracks) {
+        const int keep = qMin(track.size, mCapacity);
+        Track resized{ 0, keep, {}, {}, {} };
+        resized.geoPoints.resize(mCapacity);
+        resized.projPoints.resize(mCapacity);
+        resized.timestamps.resize(mCapacity);
+        const int capacity = track.geoPoints.size();
+        for (int k = 0; k < keep; ++k) {
+            const int index = (track.start + track.size - keep + k) % capacity;
+            resized.geoPoints[k] = track.geoPoints.at(index);
+            resized.projPoints[k] = track.projPoints.at(index);
+            resized.timestamps[k] = track.timestamps.at(index);
+        }
+        track = resized;
+    }
+    mItem->repaint();
+}
+
+int QGVLayerTrails::getCapacity() const
+{
+    return mCapacity;
+}
+
+void QGVLayerTrails::setMaxAge(qint64 msecs)
+{
+    mMaxAge = msecs;
+}
+
+qint64 QGVLayerTrails::getMaxAge() const
+{
+    return mMaxAge;
+}
+
+void QGVLayerTrails::setPen(const QPen& pen)
+{
+    mPen = pen;
+    mItem->repaint();
+}
+
+QPen QGVLayerTrails::getPen() const
+{
+    return mPen;
+}
+
+void QGVLayerTrails::appendPoint(int trackId, const QGV::GeoPos& geoPos, qint64 timestamp)
+{
+    auto iter = mTracks.find(trackId);
+    if (iter == mTracks.end()) {
+        Track track{ 0, 0, {}, {}, {} };
+        track.geoPoints.resize(mCapacity);
+        track.projPoints.resize(mCapacity);
+        track.timestamps.resize(mCapacity);
+        iter = mTracks.insert(trackId, track);
+    }
+    Track& track = iter.value();
+    const int capacity = track.geoPoints.size();
+
+    QPolygonF dirtyPoints;
+    const QPointF projPos = (getMap() != nullptr) ? getMap()->getProjection()->geoToProj(geoPos) : QPointF();
+    if (track.size > 0) {
+        dirtyPoints.append(track.projPoints.at((track.start + track.size - 1) % capacity));
+    }
+    dirtyPoints.append(projPos);
+
+    const int index = (track.start + track.size) % capacity;
+    if (track.size == capacity) {
+        dirtyPoints.append(track.projPoints.at(track.start));
+        track.start = (track.start + 1) % capacity;
+    } else {
+        track.size++;
+    }
+    track.geoPoints[index] = geoPos;
+    track.projPoints[index] = projPos;
+    track.timestamps[index] = timestamp;
+
+    expireTrack(track, timestamp, dirtyPoints);
+    repaintArea(dirtyPoints);
+}
+
+void QGVLayerTrails::removeTrack(int trackId)
+{
+    if (mTracks.remove(trackId) > 0) {
+        mItem->repaint();
+    }
+}
+
+void QGVLayerTrails::clearTracks()
+{
+    mTracks.clear();
+    mItem->repaint();
+}
+
+int QGVLayerTrails::countTracks() const
+{
+    return mTracks.size();
+}
+
+int QGVLayerTrails::countPoints(int trackId) const
+{
+    const auto iter = mTracks.constFind(trackId);
+    return (iter != mTracks.constEnd()) ? iter->size : 0;
+}
+
+void QGVLayerTrails::expire(qint64 now)
+{
+    QPolygonF dirtyPoints;
+    for (auto iter = mTracks.begin(); iter != mTracks.end();) {
+        expireTrack(iter.value(), now, dirtyPoints);
+        if (iter->size == 0) {
+            iter = mTracks.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    repaintArea(dirtyPoints);
+}
+
+void QGVLayerTrails::onProjectionPrepare(const QGVProjection* projection)
+{
+    projectTracks(projection);
+    mPreparedProjection = projection;
+}
+
+void QGVLayerTrails::onProjection(QGVMap* geoMap)
+{
+    QGVLayer::onProjection(geoMap);
+    if (mPreparedProjection != geoMap->getProjection()) {
+        projectTracks(geoMap->getProjection());
+    }
+    mPreparedProjection = nullptr;
+    mItem->resetBoundary();
+    mItem->repaint();
+}
+
+void QGVLayerTrails::projectTracks(const QGVProjection* projection)
+{
+    // Points of all tracks go through one batch call, latitudes and longitudes are projected in place
+    int total = 0;
+    for (const Track& track : mTracks) {
+        total += track.size;
+    }
+    QVector<double> x(total);
+    QVector<double> y(total);
+    int offset = 0;
+    for (const Track& track : mTracks) {
+        const int capacity = track.geoPoints.size();
+        for (int k = 0; k < track.size; ++k) {
+            const QGV::GeoPos& geoPos = track.geoPoints.at((track.start + k) % capacity);
+            y[offset + k] = geoPos.latitude();
+            x[offset + k] = geoPos.longitude();
+        }
+        offset += track.size;
+    }
+    projection->geoToProj(y.constData(), x.constData(), x.data(), y.data(), total);
+    offset = 0;
+    for (Track& track : mTracks) {
+        const int capacity = track.geoPoints.size();
+        for (int k = 0; k < track.size; ++k) {
+            track.projPoints[(track.start + k) % capacity] = QPointF(x.at(offset + k), y.at(offset + k));
+        }
+        offset += track.size;
+    }
+}
+
+int QGVLayerTrails::expireTrack(Track& track, qint64 now, QPolygonF& dirtyPoints) const
+{
+    if (mMaxAge <= 0) {
+        return 0;
+    }
+    const int capacity = track.geoPoints.size();
+    int expired = 0;
+    while (track.size > 0 && now - track.timestamps.at(track.start) > mMaxAge) {
+        dirtyPoints.append(track.projPoints.at(track.start));
+        track.start = (track.start + 1) % capacity;
+        track.size--;
+        expired++;
+    }
+    if (expired > 0 && track.size > 0) {
+        dirtyPoints.append(track.projPoints.at(track.start));
+    }
+    return expired;
+}
+
+void QGVLayerTrails::repaintArea(const QPolygonF& dirtyPoints)
+{
+    if (getMap() == nullptr || dirtyPoints.isEmpty()) {
+        return;
+    }
+    const double margin = qMax(1.0, mPen.widthF()) / getMap()->getCamera().scale();
+    mItem->repaint(dirtyPoints.boundingRect().adjusted(-margin, -margin, margin, margin));
+}
+
+QRectF QGVLayerTrails::projBoundingRect() const
+{
+    if (getMap() == nullptr) {
+        return {};
+    }
+    return getMap()->getProjection()->boundaryProjRect();
+}
+
+void QGVLayerTrails::projPaint(QPainter* painter)
+{
+    if (mTracks.isEmpty()) {
+        return;
+    }
+    const QGVCameraState camera = getMap()->getCamera();
+    const double minDistance = decimationPixels / camera.scale();
+    const double minDistance2 = minDistance * minDistance;
+    const double margin = qMax(1.0, mPen.widthF()) / camera.scale();
+    const QRectF area = camera.projRect().adjusted(-margin, -margin, margin, margin);
+
+    // Points closer than a couple of pixels to previous drawn one are skipped
+    mPaintLines.resize(0);
+    for (const Track& track : mTracks) {
+        if (track.size < 2) {
+            continue;
+        }
+        const int capacity = track.projPoints.size();
+        const QPointF* points = track.projPoints.constData();
+        QPointF last = points[track.start];
+        for (int k = 1; k < track.size; ++k) {
+            const QPointF& current = points[(track.start + k) % capacity];
+            const QPointF delta = current - last;
+            if (k < track.size - 1 && QPointF::dotProduct(delta, delta) < minDistance2) {
+                continue;
+            }
+            if (isSegmentInArea(area, last, current)) {
+                mPaintLines.append(QLineF(last, current));
+            }
+            last = current;
+        }
+    }
+    if (mPaintLines.isEmpty()) {
+        return;
+    }
+    painter->setPen(mPen);
+    painter->drawLines(mPaintLines.constData(), mPaintLines.size());
+}
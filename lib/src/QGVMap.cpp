@@ -17,10 +17,12 @@
  ****************************************************************************/
 
 #include "QGVMap.h"
+#include "QGVFrameScheduler.h"
 #include "QGVItem.h"
 #include "QGVMapQGItem.h"
 #include "QGVMapQGView.h"
 #include "QGVProjectionEPSG3857.h"
+#include "QGVProjectionEPSG4326.h"
 #include "QGVWidget.h"
 
 #include <QMouseEvent>
@@ -45,10 +47,24 @@ private:
 };
 RootItem::~RootItem() = default;
 
+namespace {
+void collectCameraItems(QGVItem* item, const QSet<QGVItem*>& cameraItems, QVector<QGVItem*>& result)
+{
+    if (cameraItems.contains(item)) {
+        result.append(item);
+    }
+    for (int i = 0; i < item->countItems(); ++i) {
+        collectCameraItems(item->getItem(i), cameraItems, result);
+    }
+}
+}
+
 QGVMap::QGVMap(QWidget* parent)
     : QWidget(parent)
 {
+    mCameraOrderDirty = true;
     mProjection.reset(new QGVProjectionEPSG3857());
+    mFrameScheduler.reset(new QGVFrameScheduler());
     mQGView.reset(new QGVMapQGView(this));
     mRootItem.reset(new RootItem(this));
     setLayout(new QVBoxLayout(this));
@@ -88,6 +104,9 @@ void QGVMap::setProjection(QGV::Projection id)
         case QGV::Projection::EPSG3857:
             setProjection(new QGVProjectionEPSG3857());
             break;
+        case QGV::Projection::EPSG4326:
+            setProjection(new QGVProjectionEPSG4326());
+            break;
     }
 }
 
@@ -129,6 +148,17 @@ bool QGVMap::isMouseAction(QGV::MouseAction action) const
     return getMouseActions().testFlag(action);
 }
 
+void QGVMap::setWorldWrap(bool enabled)
+{
+    geoView()->setWorldWrap(enabled);
+    refreshMap();
+}
+
+bool QGVMap::isWorldWrap() const
+{
+    return geoView()->isWorldWrap();
+}
+
 QGVItem* QGVMap::rootItem() const
 {
     return mRootItem.data();
@@ -139,6 +169,11 @@ QGVMapQGView* QGVMap::geoView() const
     return mQGView.data();
 }
 
+QGVFrameScheduler* QGVMap::frameScheduler() const
+{
+    return mFrameScheduler.data();
+}
+
 void QGVMap::addItem(QGVItem* item)
 {
     Q_ASSERT(item);
@@ -166,6 +201,20 @@ QGVItem* QGVMap::getItem(int index) const
     return mRootItem->getItem(index);
 }
 
+void QGVMap::addCameraItem(QGVItem* item)
+{
+    Q_ASSERT(item);
+    mCameraItems.insert(item);
+    mCameraOrderDirty = true;
+}
+
+void QGVMap::removeCameraItem(QGVItem* item)
+{
+    if (mCameraItems.remove(item)) {
+        mCameraOrderDirty = true;
+    }
+}
+
 void QGVMap::addWidget(QGVWidget* widget)
 {
     Q_ASSERT(widget);
@@ -236,7 +285,8 @@ QSet<QGVItem*> QGVMap::getSelections() const
 QList<QGVDrawItem*> QGVMap::search(const QPointF& projPos, Qt::ItemSelectionMode mode) const
 {
     QList<QGVDrawItem*> result;
-    for (QGraphicsItem* item : geoView()->scene()->items(projPos, mode)) {
+    const QPointF worldPos = geoView()->wrapProjPos(projPos);
+    for (QGraphicsItem* item : geoView()->scene()->items(worldPos, mode, Qt::DescendingOrder, geoView()->viewportTransform())) {
         QGVDrawItem* geoObject = QGVMapQGItem::geoObjectFromQGItem(item);
         if (geoObject)
             result << geoObject;
@@ -247,10 +297,22 @@ QList<QGVDrawItem*> QGVMap::search(const QPointF& projPos, Qt::ItemSelectionMode
 QList<QGVDrawItem*> QGVMap::search(const QRectF& projRect, Qt::ItemSelectionMode mode) const
 {
     QList<QGVDrawItem*> result;
-    for (QGraphicsItem* item : geoView()->scene()->items(projRect, mode)) {
-        QGVDrawItem* geoObject = QGVMapQGItem::geoObjectFromQGItem(item);
-        if (geoObject)
+    const QList<double> shifts = geoView()->wrapShifts(projRect);
+    QSet<QGVDrawItem*> found;
+    for (double shift : shifts) {
+        const QRectF worldRect = projRect.translated(shift, 0);
+        for (QGraphicsItem* item : geoView()->scene()->items(worldRect, mode, Qt::DescendingOrder, geoView()->viewportTransform())) {
+            QGVDrawItem* geoObject = QGVMapQGItem::geoObjectFromQGItem(item);
+            if (!geoObject)
+                continue;
+            // Same item can be hit in several world copies only when wrapping
+            if (shifts.size() > 1) {
+                if (found.contains(geoObject))
+                    continue;
+                found.insert(geoObject);
+            }
             result << geoObject;
+        }
     }
     return result;
 }
@@ -258,14 +320,42 @@ QList<QGVDrawItem*> QGVMap::search(const QRectF& projRect, Qt::ItemSelectionMode
 QList<QGVDrawItem*> QGVMap::search(const QPolygonF& projPolygon, Qt::ItemSelectionMode mode) const
 {
     QList<QGVDrawItem*> result;
-    for (QGraphicsItem* item : geoView()->scene()->items(projPolygon, mode)) {
-        QGVDrawItem* geoObject = QGVMapQGItem::geoObjectFromQGItem(item);
-        if (geoObject)
+    const QList<double> shifts = geoView()->wrapShifts(projPolygon.boundingRect());
+    QSet<QGVDrawItem*> found;
+    for (double shift : shifts) {
+        const QPolygonF worldPolygon = projPolygon.translated(shift, 0);
+        for (QGraphicsItem* item : geoView()->scene()->items(worldPolygon, mode, Qt::DescendingOrder, geoView()->viewportTransform())) {
+            QGVDrawItem* geoObject = QGVMapQGItem::geoObjectFromQGItem(item);
+            if (!geoObject)
+                continue;
+            // Same item can be hit in several world copies only when wrapping
+            if (shifts.size() > 1) {
+                if (found.contains(geoObject))
+                    continue;
+                found.insert(geoObject);
+            }
             result << geoObject;
+        }
     }
     return result;
 }
 
+QGVDrawItem* QGVMap::searchFirst(const QPointF& projPos) const
+{
+    // Scene index gives bounding rect candidates, exact test uses cached item shape
+    const QPointF worldPos = geoView()->wrapProjPos(projPos);
+    const QTransform viewTransform = geoView()->viewportTransform();
+    const auto candidates = geoView()->scene()->items(
+            worldPos, Qt::IntersectsItemBoundingRect, Qt::DescendingOrder, viewTransform);
+    for (QGraphicsItem* item : candidates) {
+        QGVMapQGItem* qgItem = dynamic_cast<QGVMapQGItem*>(item);
+        if (qgItem != nullptr && qgItem->containsProjPos(worldPos, viewTransform)) {
+            return QGVMapQGItem::geoObjectFromQGItem(qgItem);
+        }
+    }
+    return nullptr;
+}
+
 QPixmap QGVMap::grabMapView(bool includeWidgets) const
 {
     const QPixmap pixmap = (includeWidgets) ? geoView()->grab(geoView()->rect())
@@ -317,7 +407,7 @@ void QGVMap::refreshProjection()
     geoView()->scene()->setSceneRect(sceneRect);
 
     auto root = static_cast<RootItem*>(rootItem());
-    root->onProjection(this);
+    root->applyProjection(this);
 
     for (QGVWidget* widget : mWidgets) {
         widget->onProjection(this);
@@ -348,9 +438,17 @@ void QGVMap::onMapCamera(const QGVCameraState& oldState, const QGVCameraState& n
         Q_EMIT areaChanged();
     }
 
-    auto root = static_cast<RootItem*>(rootItem());
-    if (root->isVisible()) {
-        root->onCamera(oldState, newState);
+    // Camera items are visited in tree order, order is rebuilt only after registry changes
+    if (mCameraOrderDirty) {
+        mCameraOrder.clear();
+        collectCameraItems(mRootItem.data(), mCameraItems, mCameraOrder);
+        mCameraOrderDirty = false;
+    }
+    const QVector<QGVItem*> cameraOrder = mCameraOrder;
+    for (QGVItem* item : cameraOrder) {
+        if (mCameraItems.contains(item) && item->effectivelyVisible()) {
+            item->onCamera(oldState, newState);
+        }
     }
     for (QGVWidget* widget : mWidgets) {
         if (widget->isVisible()) {
@@ -24,6 +24,8 @@
 #include <QPalette>
 
 QGVMapQGItem::QGVMapQGItem(QGVDrawItem* geoObject)
+    : mGeometryValid(false)
+    , mShapeValid(false)
 {
     mGeoObject = geoObject;
     setCacheMode(QGraphicsItem::DeviceCoordinateCache);
@@ -38,15 +40,54 @@ QGVDrawItem* QGVMapQGItem::geoObjectFromQGItem(QGraphicsItem* item)
 void QGVMapQGItem::resetGeometry()
 {
     prepareGeometryChange();
+    mGeometryValid = false;
+    mShapeValid = false;
+}
+
+void QGVMapQGItem::updateProjRect(const QRectF& projRect)
+{
+    update(projRect.translated(-mProjOrigin));
+}
+
+void QGVMapQGItem::setIgnoreTransformations(bool enabled, const QPointF& projAnchor)
+{
+    const QPointF projOrigin = (enabled) ? projAnchor : QPointF();
+    if (mProjOrigin != projOrigin) {
+        prepareGeometryChange();
+        mGeometryValid = false;
+        mShapeValid = false;
+        mProjOrigin = projOrigin;
+        setPos(mProjOrigin);
+    }
+    setFlag(QGraphicsItem::ItemIgnoresTransformations, enabled);
+}
+
+bool QGVMapQGItem::containsProjPos(const QPointF& projPos, const QTransform& viewTransform) const
+{
+    bool invertible = false;
+    const QTransform toItem = deviceTransform(viewTransform).inverted(&invertible);
+    if (!invertible) {
+        return false;
+    }
+    const QPointF itemPos = toItem.map(viewTransform.map(projPos));
+    if (!boundingRect().contains(itemPos)) {
+        return false;
+    }
+    return shape().contains(itemPos);
 }
 
 QRectF QGVMapQGItem::boundingRect() const
 {
-    return mGeoObject->projShape().boundingRect();
+    if (!mGeometryValid) {
+        mBoundingRect = mGeoObject->projBoundingRect().translated(-mProjOrigin);
+        mGeometryValid = true;
+    }
+    return mBoundingRect;
 }
 
 void QGVMapQGItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* /*option*/, QWidget* /*widget*/)
 {
+    painter->translate(-mProjOrigin);
     mGeoObject->projPaint(painter);
 
     if (mGeoObject->isSelected() && !mGeoObject->isFlag(QGV::ItemFlag::SelectCustom)) {
@@ -66,7 +107,7 @@ void QGVMapQGItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* /*op
         QBrush brush = QBrush(Qt::white);
         painter->setPen(pen);
         painter->setBrush(brush);
-        auto rect = boundingRect().toRect();
+        auto rect = mGeoObject->projBoundingRect().toRect();
         auto path = QGV::createTextPath(rect, mGeoObject->projDebug(), QFont(), pen.width());
         path = QGV::createTransfromScale(rect.center(), 0.75).map(path);
         painter->drawPath(path);
@@ -84,7 +125,11 @@ void QGVMapQGItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* /*op
 
 QPainterPath QGVMapQGItem::shape() const
 {
-    return mGeoObject->projShape();
+    if (!mShapeValid) {
+        mShape = mGeoObject->projShape().translated(-mProjOrigin);
+        mShapeValid = true;
+    }
+    return mShape;
 }
 
 void QGVMapQGItem::hoverEnterEvent(QGraphicsSceneHoverEvent* /*event*/)
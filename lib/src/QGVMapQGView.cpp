@@ -18,6 +18,7 @@
 
 #include "QGVMapQGView.h"
 #include "QGVDrawItem.h"
+#include "QGVFrameScheduler.h"
 #include "QGVMap.h"
 #include "QGVMapQGItem.h"
 #include "QGVMapQGView.h"
@@ -49,6 +50,8 @@ QGVMapQGView::QGVMapQGView(QGVMap* geoMap)
     mScale = 1.0;
     mAzimuth = 0.0;
     mMouseActions = QGV::MouseAction::All;
+    mWorldWrap = false;
+    mWrapRenderShift = 0;
     mViewRect = viewport()->rect();
     mState = QGV::MapState::Idle;
     mQGScene.reset(new QGraphicsScene(this));
@@ -79,10 +82,57 @@ QGV::MouseActions QGVMapQGView::getMouseActions() const
     return mMouseActions;
 }
 
+void QGVMapQGView::setWorldWrap(bool enabled)
+{
+    if (mWorldWrap == enabled) {
+        return;
+    }
+    mWorldWrap = enabled;
+    // World copies are painted outside of item areas, so partial updates would leave them stale
+    setViewportUpdateMode((mWorldWrap) ? QGraphicsView::FullViewportUpdate : QGraphicsView::SmartViewportUpdate);
+    if (mWorldWrap) {
+        cameraMove(viewRect().center());
+    }
+    viewport()->update();
+}
+
+bool QGVMapQGView::isWorldWrap() const
+{
+    return mWorldWrap;
+}
+
+QPointF QGVMapQGView::wrapProjPos(const QPointF& projPos) const
+{
+    if (!mWorldWrap) {
+        return projPos;
+    }
+    const QRectF world = mGeoMap->getProjection()->boundaryProjRect();
+    const double copy = qFloor((projPos.x() - world.left()) / world.width());
+    return QPointF(projPos.x() - copy * world.width(), projPos.y());
+}
+
+QList<double> QGVMapQGView::wrapShifts(const QRectF& projRect) const
+{
+    if (!mWorldWrap) {
+        return { 0 };
+    }
+    // Shifts moving each world copy touched by rect into primary world
+    const QRectF world = mGeoMap->getProjection()->boundaryProjRect();
+    const int firstCopy = qFloor((projRect.left() - world.left()) / world.width());
+    const int lastCopy = qFloor((projRect.right() - world.left()) / world.width());
+    QList<double> result;
+    for (int copy = firstCopy; copy <= lastCopy; ++copy) {
+        result.append(-copy * world.width());
+    }
+    return result;
+}
+
 QGVCameraState QGVMapQGView::getCamera() const
 {
     const bool animation = mState == QGV::MapState::Animation;
-    return QGVCameraState(mGeoMap, mAzimuth, mScale, viewRect(), animation);
+    // While world copy is rendered, camera reports the area of primary world shown in that copy
+    const QRectF projRect = viewRect().translated(mWrapRenderShift, 0);
+    return QGVCameraState(mGeoMap, mAzimuth, mScale, projRect, animation);
 }
 
 void QGVMapQGView::cameraTo(const QGVCameraActions& actions, bool animation)
@@ -90,9 +140,22 @@ void QGVMapQGView::cameraTo(const QGVCameraActions& actions, bool animation)
     const QGVCameraState oldState = getCamera();
     blockCameraUpdate();
     changeState((animation) ? QGV::MapState::Animation : QGV::MapState::Idle);
-    cameraScale(actions.scale());
-    cameraMove(actions.projCenter());
-    cameraRotate(actions.azimuth());
+
+    // Whole target transform is composed once instead of separate scale/rotate steps
+    const double newScale = qMax(mMinScale, qMin(mMaxScale, actions.scale()));
+    const double newAzimuth = fmod(actions.azimuth(), 360);
+    if (!qFuzzyCompare(mScale, newScale) || !qFuzzyCompare(fmod(mAzimuth, 360), newAzimuth)) {
+        QTransform transform;
+        transform.rotate(newAzimuth);
+        transform.scale(newScale, newScale);
+        QGraphicsView::setTransform(transform);
+        mScale = newScale;
+        mAzimuth = newAzimuth;
+    }
+    const QPointF newCenter = cameraCenter(actions.projCenter());
+    if (viewRect().center() != newCenter) {
+        QGraphicsView::centerOn(newCenter);
+    }
     unblockCameraUpdate();
     applyCameraUpdate(oldState);
 }
@@ -121,7 +184,13 @@ void QGVMapQGView::cleanState()
 
 QRectF QGVMapQGView::viewRect() const
 {
-    return mapToScene(mViewRect).boundingRect();
+    const QTransform viewTransform = viewportTransform();
+    if (mCachedViewRect != mViewRect || mCachedViewTransform != viewTransform) {
+        mCachedViewRect = mViewRect;
+        mCachedViewTransform = viewTransform;
+        mCachedProjRect = viewTransform.inverted().mapRect(QRectF(mViewRect));
+    }
+    return mCachedProjRect;
 }
 
 void QGVMapQGView::changeState(QGV::MapState state)
@@ -180,13 +249,26 @@ void QGVMapQGView::cameraMove(const QPointF& projPos)
 {
     const QGVCameraState oldState = getCamera();
     const QPointF oldCenter = viewRect().center();
-    if (oldCenter != projPos) {
-        QGraphicsView::centerOn(projPos);
+    const QPointF newCenter = cameraCenter(projPos);
+    if (oldCenter != newCenter) {
+        QGraphicsView::centerOn(newCenter);
         applyCameraUpdate(oldState);
-        qgvDebug() << "cameraMove" << projPos;
+        qgvDebug() << "cameraMove" << newCenter;
     }
 }
 
+QPointF QGVMapQGView::cameraCenter(const QPointF& projPos)
+{
+    // With world wrap camera always stays in primary world, mouse anchors follow the jump
+    const QPointF newCenter = wrapProjPos(projPos);
+    const QPointF wrapShift = projPos - newCenter;
+    if (!wrapShift.isNull()) {
+        mMoveProjAnchor -= wrapShift;
+        mWheelProjAnchor -= wrapShift;
+    }
+    return newCenter;
+}
+
 void QGVMapQGView::blockCameraUpdate()
 {
     mBlockUpdateCount++;
@@ -219,8 +301,7 @@ void QGVMapQGView::showTooltip(QHelpEvent* helpEvent)
     }
     helpEvent->accept();
     const QPointF projMouse = mapToScene(helpEvent->pos());
-    QGraphicsItem* item = itemAt(helpEvent->pos());
-    QGVDrawItem* geoObject = QGVMapQGItem::geoObjectFromQGItem(item);
+    QGVDrawItem* geoObject = mGeoMap->searchFirst(projMouse);
     QString toolTip = QString();
     if (geoObject != nullptr) {
         toolTip = geoObject->projTooltip(projMouse);
@@ -300,11 +381,10 @@ void QGVMapQGView::startMovingObject(QMouseEvent* event)
         return;
     }
     const QPointF projPos = mapToScene(event->pos());
-    auto geoObjects = mGeoMap->search(projPos, Qt::ContainsItemShape);
-    if (geoObjects.isEmpty()) {
+    auto* geoObject = mGeoMap->searchFirst(projPos);
+    if (geoObject == nullptr) {
         return;
     }
-    auto* geoObject = geoObjects.first();
     if (!geoObject->isFlag(QGV::ItemFlag::Movable)) {
         changeState(QGV::MapState::Idle);
         return;
@@ -390,11 +470,10 @@ void QGVMapQGView::objectClick(QMouseEvent* event)
         return;
     }
     const QPointF projPos = mapToScene(event->pos());
-    auto geoObjects = mGeoMap->search(projPos, Qt::ContainsItemShape);
-    if (geoObjects.isEmpty()) {
+    auto* geoObject = mGeoMap->searchFirst(projPos);
+    if (geoObject == nullptr) {
         return;
     }
-    auto* geoObject = geoObjects.first();
     if (mMouseActions.testFlag(QGV::MouseAction::Selection) && geoObject->isSelectable()) {
         if (event->button() == Qt::LeftButton) {
             const bool wasSelect = geoObject->isSelected();
@@ -420,11 +499,10 @@ void QGVMapQGView::objectDoubleClick(QMouseEvent* event)
         return;
     }
     const QPointF projPos = mapToScene(event->pos());
-    auto geoObjects = mGeoMap->search(projPos, Qt::ContainsItemShape);
-    if (geoObjects.isEmpty()) {
+    auto* geoObject = mGeoMap->searchFirst(projPos);
+    if (geoObject == nullptr) {
         return;
     }
-    auto* geoObject = geoObjects.first();
     if (geoObject->isFlag(QGV::ItemFlag::Clickable)) {
         if (event->button() == Qt::LeftButton) {
             geoObject->projOnMouseDoubleClick(projPos);
@@ -462,11 +540,7 @@ void QGVMapQGView::moveMap(QMouseEvent* event)
         return;
     }
     event->accept();
-    const QPointF projCenter = viewRect().center();
-    const QPointF projMouse = mapToScene(event->pos());
-    const double xDelta = (mMoveProjAnchor.x() - projMouse.x());
-    const double yDelta = (mMoveProjAnchor.y() - projMouse.y());
-    cameraMove(projCenter + QPointF(xDelta, yDelta));
+    scheduleMove(event->pos());
 }
 
 void QGVMapQGView::moveObject(QMouseEvent* event)
@@ -477,8 +551,27 @@ void QGVMapQGView::moveObject(QMouseEvent* event)
     }
     Q_ASSERT(mMovingObject);
     event->accept();
-    const QPointF projMouse = mapToScene(event->pos());
-    mMovingObject->projOnObjectMovePos(projMouse);
+    scheduleMove(event->pos());
+}
+
+void QGVMapQGView::scheduleMove(const QPoint& pos)
+{
+    // Pointer moves within one frame are coalesced, latest position wins
+    mPendingMovePos = pos;
+    mGeoMap->frameScheduler()->schedule(this, [this]() { applyMove(); });
+}
+
+void QGVMapQGView::applyMove()
+{
+    const QPointF projMouse = mapToScene(mPendingMovePos);
+    if (mState == QGV::MapState::MovingMap) {
+        const QPointF projCenter = viewRect().center();
+        const double xDelta = (mMoveProjAnchor.x() - projMouse.x());
+        const double yDelta = (mMoveProjAnchor.y() - projMouse.y());
+        cameraMove(projCenter + QPointF(xDelta, yDelta));
+    } else if (mState == QGV::MapState::MovingObjects && mMovingObject != nullptr) {
+        mMovingObject->projOnObjectMovePos(projMouse);
+    }
 }
 
 void QGVMapQGView::unselectAll(QMouseEvent* event)
@@ -543,6 +636,7 @@ void QGVMapQGView::mousePressEvent(QMouseEvent* event)
 void QGVMapQGView::mouseReleaseEvent(QMouseEvent* event)
 {
     event->ignore();
+    mGeoMap->frameScheduler()->flush(this);
     if (mState == QGV::MapState::MovingObjects) {
         stopMovingObject(event);
     } else if (mState == QGV::MapState::SelectionRect) {
@@ -626,3 +720,33 @@ void QGVMapQGView::dragLeaveEvent(QDragLeaveEvent* event)
 {
     event->accept();
 }
+
+void QGVMapQGView::drawForeground(QPainter* painter, const QRectF& rect)
+{
+    QGraphicsView::drawForeground(painter, rect);
+    if (!mWorldWrap) {
+        return;
+    }
+
+    // Visible world copies reuse scene content under offset, no items are duplicated
+    const QRectF world = mGeoMap->getProjection()->boundaryProjRect();
+    const double width = world.width();
+    const int firstCopy = qFloor((rect.left() - world.left()) / width);
+    const int lastCopy = qFloor((rect.right() - world.left()) / width);
+    for (int copy = firstCopy; copy <= lastCopy; ++copy) {
+        if (copy == 0) {
+            continue;
+        }
+        const QRectF copyRect(world.left() + copy * width, rect.top(), width, rect.height());
+        const QRectF target = rect.intersected(copyRect);
+        if (target.isEmpty()) {
+            continue;
+        }
+        painter->save();
+        painter->setClipRect(target);
+        mWrapRenderShift = -copy * width;
+        scene()->render(painter, target, target.translated(mWrapRenderShift, 0), Qt::IgnoreAspectRatio);
+        mWrapRenderShift = 0;
+        painter->restore();
+    }
+}
@@ -39,3 +39,21 @@ QString QGVProjection::getDescription() const
 {
     return mDescription;
 }
+
+void QGVProjection::geoToProj(const double* lat, const double* lon, double* x, double* y, int count) const
+{
+    for (int i = 0; i < count; ++i) {
+        const QPointF projPos = geoToProj(QGV::GeoPos(lat[i], lon[i]));
+        x[i] = projPos.x();
+        y[i] = projPos.y();
+    }
+}
+
+void QGVProjection::projToGeo(const double* x, const double* y, double* lat, double* lon, int count) const
+{
+    for (int i = 0; i < count; ++i) {
+        const QGV::GeoPos geoPos = projToGeo(QPointF(x[i], y[i]));
+        lat[i] = geoPos.latitude();
+        lon[i] = geoPos.longitude();
+    }
+}
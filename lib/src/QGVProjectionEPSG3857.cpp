@@ -17,10 +17,20 @@
  ****************************************************************************/
 
 #include "QGVProjectionEPSG3857.h"
+#include "QGVGeodesic.h"
+#include "QGVUtils.h"
 
 #include <QLineF>
 #include <QtMath>
 
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int parallelMinCount = 64 * 1024;
+const int parallelChunk = 16 * 1024;
+}
+
 QGVProjectionEPSG3857::QGVProjectionEPSG3857()
     : QGVProjection("EPSG3857",
                     "WGS84 Web Mercator",
@@ -78,13 +88,46 @@ QGV::GeoRect QGVProjectionEPSG3857::projToGeo(const QRectF& projRect) const
 
 double QGVProjectionEPSG3857::geodesicMeters(const QPointF& projPos1, const QPointF& projPos2) const
 {
-    const QGV::GeoPos geoPos1 = projToGeo(projPos1);
-    const QGV::GeoPos geoPos2 = projToGeo(projPos2);
-    const double latitudeArc = (geoPos1.latitude() - geoPos2.latitude()) * M_PI / 180.0;
-    const double longitudeArc = (geoPos1.longitude() - geoPos2.longitude()) * M_PI / 180.0;
-    const double latitudeH = qPow(sin(latitudeArc * 0.5), 2);
-    const double lontitudeH = qPow(sin(longitudeArc * 0.5), 2);
-    const double lonFactor = cos(geoPos1.latitude() * M_PI / 180.0) * cos(geoPos2.latitude() * M_PI / 180.0);
-    const double arcInRadians = 2.0 * asin(sqrt(latitudeH + lonFactor * lontitudeH));
-    return mEarthRadius * arcInRadians;
+    return QGV::geodesicDistance(projToGeo(projPos1), projToGeo(projPos2));
+}
+
+void QGVProjectionEPSG3857::geoToProj(const double* lat, const double* lon, double* x, double* y, int count) const
+{
+    // Scalar loop with hoisted constants, log/tan are libm calls and are not vectorized.
+    // Speedup comes from skipping per point virtual calls and from splitting large inputs between threads
+    const double maxLat = mGeoBoundary.topLeft().latitude();
+    const double radius = mEarthRadius;
+    const double lonFactor = mOriginShift / 180.0;
+    const auto kernel = [=](int from, int to) {
+        for (int i = from; i < to; ++i) {
+            const double clampedLat = std::min(lat[i], maxLat);
+            const double geoLon = lon[i];
+            x[i] = geoLon * lonFactor;
+            y[i] = -radius * std::log(std::tan((90.0 + clampedLat) * (M_PI / 360.0)));
+        }
+    };
+    if (count >= parallelMinCount) {
+        QGV::parallelFor(count, parallelChunk, kernel);
+    } else {
+        kernel(0, count);
+    }
+}
+
+void QGVProjectionEPSG3857::projToGeo(const double* x, const double* y, double* lat, double* lon, int count) const
+{
+    const double invRadius = 1.0 / mEarthRadius;
+    const double lonFactor = 180.0 / mOriginShift;
+    const auto kernel = [=](int from, int to) {
+        for (int i = from; i < to; ++i) {
+            const double projX = x[i];
+            const double projY = y[i];
+            lon[i] = projX * lonFactor;
+            lat[i] = (180.0 / M_PI) * (2.0 * std::atan(std::exp(-projY * invRadius)) - M_PI / 2.0);
+        }
+    };
+    if (count >= parallelMinCount) {
+        QGV::parallelFor(count, parallelChunk, kernel);
+    } else {
+        kernel(0, count);
+    }
 }
@@ -0,0 +1,96 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "QGVProjectionEPSG4326.h"
+#include "QGVGeodesic.h"
+
+#include <QtMath>
+
+QGVProjectionEPSG4326::QGVProjectionEPSG4326()
+    : QGVProjection("EPSG4326",
+                    "WGS84 Equirectangular",
+                    "Plate carree projection of WGS84 coordinates, where "
+                    "longitude and latitude map linearly to the plane. "
+                    "Scaled to meters at the equator.")
+{
+    mEarthRadius = 6378137.0; /* meters */
+    mMetersPerDegree = M_PI * mEarthRadius / 180.0;
+    mGeoBoundary = QGV::GeoRect(90, -180, -90, +180);
+    mProjBoundary = geoToProj(mGeoBoundary);
+}
+
+QGV::GeoRect QGVProjectionEPSG4326::boundaryGeoRect() const
+{
+    return mGeoBoundary;
+}
+
+QRectF QGVProjectionEPSG4326::boundaryProjRect() const
+{
+    return mProjBoundary;
+}
+
+QPointF QGVProjectionEPSG4326::geoToProj(const QGV::GeoPos& geoPos) const
+{
+    const double lat = qBound(-90.0, geoPos.latitude(), 90.0);
+    return QPointF(geoPos.longitude() * mMetersPerDegree, -lat * mMetersPerDegree);
+}
+
+QGV::GeoPos QGVProjectionEPSG4326::projToGeo(const QPointF& projPos) const
+{
+    return QGV::GeoPos(-projPos.y() / mMetersPerDegree, projPos.x() / mMetersPerDegree);
+}
+
+QRectF QGVProjectionEPSG4326::geoToProj(const QGV::GeoRect& geoRect) const
+{
+    QRectF rect;
+    rect.setTopLeft(geoToProj(geoRect.topLeft()));
+    rect.setBottomRight(geoToProj(geoRect.bottomRight()));
+    return rect;
+}
+
+QGV::GeoRect QGVProjectionEPSG4326::projToGeo(const QRectF& projRect) const
+{
+    return QGV::GeoRect(projToGeo(projRect.topLeft()), projToGeo(projRect.bottomRight()));
+}
+
+double QGVProjectionEPSG4326::geodesicMeters(const QPointF& projPos1, const QPointF& projPos2) const
+{
+    return QGV::geodesicDistance(projToGeo(projPos1), projToGeo(projPos2));
+}
+
+void QGVProjectionEPSG4326::geoToProj(const double* lat, const double* lon, double* x, double* y, int count) const
+{
+    const double factor = mMetersPerDegree;
+    for (int i = 0; i < count; ++i) {
+        const double geoLat = lat[i];
+        const double geoLon = lon[i];
+        x[i] = geoLon * factor;
+        y[i] = -qBound(-90.0, geoLat, 90.0) * factor;
+    }
+}
+
+void QGVProjectionEPSG4326::projToGeo(const double* x, const double* y, double* lat, double* lon, int count) const
+{
+    const double factor = 1.0 / mMetersPerDegree;
+    for (int i = 0; i < count; ++i) {
+        const double projX = x[i];
+        const double projY = y[i];
+        lat[i] = -projY * factor;
+        lon[i] = projX * factor;
+    }
+}
@@ -17,8 +17,43 @@
  ****************************************************************************/
 
 #include "QGVUtils.h"
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
 #include <QtGlobal>
 
+#include <memory>
+#include <vector>
+
+namespace {
+
+class ParallelForTask : public QRunnable
+{
+public:
+    ParallelForTask(const std::function<void(int, int)>& func, int from, int to, QSemaphore* done)
+        : mFunc(func)
+        , mFrom(from)
+        , mTo(to)
+        , mDone(done)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        mFunc(mFrom, mTo);
+        mDone->release();
+    }
+
+private:
+    const std::function<void(int, int)>& mFunc;
+    int mFrom;
+    int mTo;
+    QSemaphore* mDone;
+};
+
+} // namespace
+
 namespace QGV {
 
 double metersToDistance(const double meters, const DistanceUnits unit)
@@ -47,4 +82,31 @@ QString unitToString(const DistanceUnits unit)
     return "";
 }
 
+void parallelFor(int count, int minChunk, const std::function<void(int from, int to)>& func)
+{
+    QThreadPool* pool = QThreadPool::globalInstance();
+    const int chunks = qMin(qMax(1, pool->maxThreadCount()), count / qMax(1, minChunk));
+    if (chunks <= 1) {
+        func(0, count);
+        return;
+    }
+
+    // Calling thread takes the first chunk and then any chunks still waiting in the pool
+    QSemaphore done;
+    std::vector<std::unique_ptr<ParallelForTask>> tasks;
+    for (int chunk = 1; chunk < chunks; ++chunk) {
+        const int from = static_cast<int>(static_cast<qint64>(count) * chunk / chunks);
+        const int to = static_cast<int>(static_cast<qint64>(count) * (chunk + 1) / chunks);
+        tasks.emplace_back(new ParallelForTask(func, from, to, &done));
+        pool->start(tasks.back().get());
+    }
+    func(0, static_cast<int>(static_cast<qint64>(count) / chunks));
+    for (auto& task : tasks) {
+        if (pool->tryTake(task.get())) {
+            task->run();
+        }
+    }
+    done.acquire(chunks - 1);
+}
+
 } // namespace QGV
@@ -18,13 +18,21 @@
 
 #include "Raster/QGVIcon.h"
 #include "QGVMap.h"
+#include "Raster/QGVIconAtlas.h"
 
 #include <QPainter>
 
 QGVIcon::QGVIcon()
+    : mAtlasHandle{ -1 }
 {
     setFlag(QGV::ItemFlag::IgnoreScale);
     setFlag(QGV::ItemFlag::IgnoreAzimuth);
+    setCacheMode(QGraphicsItem::NoCache);
+}
+
+QGVIcon::~QGVIcon()
+{
+    QGVIconAtlas::instance()->release(mAtlasHandle);
 }
 
 void QGVIcon::setGeometry(const QGV::GeoPos& geoPos, const QSizeF& imageSize)
@@ -47,12 +55,15 @@ void QGVIcon::setGeometry(const QPointF& projPos, const QSizeF& imageSize)
 
 QImage QGVIcon::getImage() const
 {
+    if (mAtlasHandle >= 0) {
+        return QGVIconAtlas::instance()->image(mAtlasHandle);
+    }
     return mImage;
 }
 
 bool QGVIcon::isImage() const
 {
-    return !mImage.isNull();
+    return !getImage().isNull();
 }
 
 void QGVIcon::loadImage(const QByteArray& rawData)
@@ -64,7 +75,10 @@ void QGVIcon::loadImage(const QByteArray& rawData)
 
 void QGVIcon::loadImage(const QImage& image)
 {
+    QGVIconAtlas::instance()->release(mAtlasHandle);
+    mAtlasHandle = -1;
     mImage = image;
+    mAtlasPixelSize = {};
     calculateGeometry();
 }
 
@@ -83,14 +97,16 @@ QPainterPath QGVIcon::projShape() const
 
 void QGVIcon::projPaint(QPainter* painter)
 {
-    if (mImage.isNull() || mProjRect.isEmpty()) {
+    if (!isImage() || mProjRect.isEmpty()) {
         return;
     }
 
-    QRectF paintRect = mProjRect;
-
     painter->setRenderHint(QPainter::SmoothPixmapTransform);
-    painter->drawImage(paintRect, getImage());
+    if (mAtlasHandle >= 0) {
+        QGVIconAtlas::instance()->draw(painter, mAtlasHandle, mProjRect);
+    } else {
+        painter->drawImage(mProjRect, getImage());
+    }
 }
 
 void QGVIcon::calculateGeometry()
@@ -103,11 +119,23 @@ void QGVIcon::calculateGeometry()
         mProjPos = getMap()->getProjection()->geoToProj(mGeoPos);
     }
 
-    const QSizeF baseSize = !mImageSize.isEmpty() ? mImageSize : mImage.size();
+    const QImage image = getImage();
+    const QSizeF baseSize = !mImageSize.isEmpty() ? mImageSize : image.size();
     const QPointF baseAnchor = QPointF(baseSize.width() / 2, baseSize.height() / 2);
 
     mProjRect = QRectF(mProjPos - baseAnchor, baseSize);
 
+    const qreal pixelRatio = getMap()->devicePixelRatioF();
+    const QSize pixelSize = (baseSize * pixelRatio).toSize();
+    if (pixelSize != mAtlasPixelSize) {
+        const int oldHandle = mAtlasHandle;
+        mAtlasHandle = QGVIconAtlas::instance()->acquire(image, baseSize, pixelRatio);
+        mAtlasPixelSize = pixelSize;
+        QGVIconAtlas::instance()->release(oldHandle);
+        // Atlas keeps the source image shared between icons, own copy is held only without atlas slot
+        mImage = (mAtlasHandle >= 0) ? QImage() : image;
+    }
+
     resetBoundary();
     refresh();
 }
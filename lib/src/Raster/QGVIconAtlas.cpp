@@ -0,0 +1,199 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "Raster/QGVIconAtlas.h"
+
+#include <QCoreApplication>
+#include <QPainter>
+
+namespace {
+const int pageSize = 1024;
+
+quint64 sizeKey(const QSize& size)
+{
+    return (static_cast<quint64>(static_cast<quint32>(size.width())) << 32) | static_cast<quint32>(size.height());
+}
+}
+
+QGVIconAtlas::QGVIconAtlas()
+{
+}
+
+QGVIconAtlas* QGVIconAtlas::instance()
+{
+    // Pixmaps must not outlive the gui application, so pages are dropped when application quits
+    static QGVIconAtlas atlas;
+    static bool connected = false;
+    if (!connected && QCoreApplication::instance() != nullptr) {
+        QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, [] { atlas.clear(); });
+        connected = true;
+    }
+    return &atlas;
+}
+
+int QGVIconAtlas::acquire(const QImage& image, const QSizeF& size, qreal devicePixelRatio)
+{
+    if (image.isNull() || size.isEmpty()) {
+        return -1;
+    }
+    const QSize pixelSize = (size * devicePixelRatio).toSize().expandedTo(QSize(1, 1));
+    // Copies of one QImage share cache key, so lookup does not touch the pixels
+    const Key key(image.cacheKey(), sizeKey(pixelSize));
+    const auto iter = mIndex.constFind(key);
+    if (iter != mIndex.constEnd()) {
+        Entry& entry = mEntries[iter.value()];
+        if (entry.refs == 0) {
+            mFree.remove(sizeKey(entry.rect.size()), iter.value());
+            entry.source = image;
+        }
+        entry.refs++;
+        return iter.value();
+    }
+
+    // Released slots of the same pixel size are reused before the atlas grows
+    int handle = -1;
+    const auto freeIter = mFree.find(sizeKey(pixelSize));
+    if (freeIter != mFree.end()) {
+        handle = freeIter.value();
+        mFree.erase(freeIter);
+        mIndex.remove(mEntries.at(handle).key);
+    } else {
+        Entry entry{ Key(), QImage(), -1, QRect(), 0 };
+        if (!allocate(pixelSize, entry.page, entry.rect)) {
+            return -1;
+        }
+        handle = mEntries.size();
+        mEntries.append(entry);
+    }
+    Entry& entry = mEntries[handle];
+    entry.key = key;
+    entry.source = image;
+    entry.refs = 1;
+    mIndex.insert(key, handle);
+
+    QPainter painter(&mPages[entry.page].pixmap);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(entry.rect, Qt::transparent);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawImage(entry.rect, image);
+    painter.end();
+
+    qgvDebug() << "icon atlas add" << handle << pixelSize << "page" << entry.page;
+    return handle;
+}
+
+void QGVIconAtlas::release(int handle)
+{
+    if (handle < 0 || handle >= mEntries.size()) {
+        return;
+    }
+    Entry& entry = mEntries[handle];
+    if (entry.refs <= 0) {
+        return;
+    }
+    entry.refs--;
+    if (entry.refs == 0) {
+        entry.source = QImage();
+        if (entry.page >= 0) {
+            mFree.insert(sizeKey(entry.rect.size()), handle);
+        }
+    }
+}
+
+void QGVIconAtlas::draw(QPainter* painter, int handle, const QRectF& targetRect) const
+{
+    if (handle < 0 || handle >= mEntries.size()) {
+        return;
+    }
+    const Entry& entry = mEntries.at(handle);
+    if (entry.page < 0) {
+        return;
+    }
+    painter->drawPixmap(targetRect, mPages.at(entry.page).pixmap, entry.rect);
+}
+
+QImage QGVIconAtlas::image(int handle) const
+{
+    if (handle < 0 || handle >= mEntries.size()) {
+        return {};
+    }
+    return mEntries.at(handle).source;
+}
+
+int QGVIconAtlas::countIcons() const
+{
+    return mIndex.size() - mFree.size();
+}
+
+int QGVIconAtlas::countPages() const
+{
+    return mPages.size();
+}
+
+bool QGVIconAtlas::allocate(const QSize& pixelSize, int& page, QRect& rect)
+{
+    if (pixelSize.width() > pageSize || pixelSize.height() > pageSize) {
+        Page single{ QPixmap(pixelSize), {}, pixelSize.height() };
+        single.pixmap.fill(Qt::transparent);
+        page = mPages.size();
+        rect = QRect(QPoint(0, 0), pixelSize);
+        mPages.append(single);
+        return true;
+    }
+
+    for (int index = 0; index < mPages.size(); ++index) {
+        Page& current = mPages[index];
+        if (current.pixmap.width() != pageSize) {
+            continue;
+        }
+        for (Shelf& shelf : current.shelves) {
+            if (shelf.height >= pixelSize.height() && shelf.height <= 2 * pixelSize.height() &&
+                shelf.cursor + pixelSize.width() <= pageSize) {
+                page = index;
+                rect = QRect(QPoint(shelf.cursor, shelf.top), pixelSize);
+                shelf.cursor += pixelSize.width();
+                return true;
+            }
+        }
+        if (current.used + pixelSize.height() <= pageSize) {
+            current.shelves.append({ current.used, pixelSize.height(), pixelSize.width() });
+            page = index;
+            rect = QRect(QPoint(0, current.used), pixelSize);
+            current.used += pixelSize.height();
+            return true;
+        }
+    }
+
+    Page newPage{ QPixmap(pageSize, pageSize), {}, 0 };
+    newPage.pixmap.fill(Qt::transparent);
+    mPages.append(newPage);
+    return allocate(pixelSize, page, rect);
+}
+
+void QGVIconAtlas::clear()
+{
+    // Entries stay allocated so handles still held by icons are not reused
+    for (Entry& entry : mEntries) {
+        entry.source = QImage();
+        entry.page = -1;
+        entry.refs = 0;
+    }
+    mPages.clear();
+    mIndex.clear();
+    mFree.clear();
+}
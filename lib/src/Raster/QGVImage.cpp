@@ -20,6 +20,7 @@
 #include "QGVMap.h"
 
 #include <QPainter>
+#include <QtMath>
 
 QGVImage::QGVImage()
     : mCeilingOnScale{ true }
@@ -59,7 +60,13 @@ void QGVImage::loadImage(const QByteArray& rawData)
 
 void QGVImage::loadImage(const QImage& image)
 {
-    mImage = image;
+    if (image.format() == QImage::Format_ARGB32_Premultiplied || image.format() == QImage::Format_RGB32) {
+        mImage = image;
+    } else {
+        mImage = image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                               : QImage::Format_RGB32);
+    }
+    mMipLevels.clear();
     calculateGeometry();
 }
 
@@ -94,8 +101,31 @@ void QGVImage::projPaint(QPainter* painter)
         paintRect.setSize(paintRect.size() + QSizeF(pixelFactor, pixelFactor));
     }
 
+    const QTransform& transform = painter->transform();
+    const double deviceWidth = paintRect.width() * qSqrt(qAbs(transform.determinant()));
+
     painter->setRenderHint(QPainter::SmoothPixmapTransform);
-    painter->drawImage(paintRect, getImage());
+    painter->drawImage(paintRect, mipLevel(deviceWidth));
+}
+
+const QImage& QGVImage::mipLevel(double deviceWidth)
+{
+    // Smallest level that is still not upscaled on screen, levels are built on demand
+    if (mMipLevels.isEmpty()) {
+        mMipLevels.append(mImage);
+    }
+    int level = 0;
+    while (true) {
+        const QImage& current = mMipLevels.at(level);
+        if (current.width() / 2 < deviceWidth || current.width() < 2 || current.height() < 2) {
+            break;
+        }
+        if (level + 1 == mMipLevels.size()) {
+            mMipLevels.append(current.scaled(current.size() / 2, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+        }
+        level++;
+    }
+    return mMipLevels.at(level);
 }
 
 void QGVImage::calculateGeometry()
@@ -0,0 +1,146 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "Raster/QGVRasterWarp.h"
+#include "QGVProjection.h"
+
+#include <QtMath>
+
+namespace {
+const float identityTolerance = 0.01f;
+
+inline QRgb interpolate(QRgb first, QRgb second, quint32 weight)
+{
+    const quint32 rest = 256 - weight;
+    const quint32 rb = (((first & 0xff00ff) * rest + (second & 0xff00ff) * weight) >> 8) & 0xff00ff;
+    const quint32 ag = (((first >> 8) & 0xff00ff) * rest + ((second >> 8) & 0xff00ff) * weight) & 0xff00ff00;
+    return rb | ag;
+}
+}
+
+QGVRasterWarp::QGVRasterWarp()
+    : mIdentity(true)
+{
+}
+
+QGVRasterWarp::QGVRasterWarp(const QGVProjection* source,
+                             const QGVProjection* target,
+                             const QGV::GeoRect& geoRect,
+                             const QSize& size)
+    : mSize(size)
+    , mIdentity(true)
+{
+    if (size.isEmpty()) {
+        return;
+    }
+    mColumns = calculateLookup(source, target, geoRect, false);
+    mRows = calculateLookup(source, target, geoRect, true);
+    for (int i = 0; i < mColumns.size() && mIdentity; ++i) {
+        mIdentity = qAbs(mColumns[i] - i) < identityTolerance;
+    }
+    for (int i = 0; i < mRows.size() && mIdentity; ++i) {
+        mIdentity = qAbs(mRows[i] - i) < identityTolerance;
+    }
+}
+
+QSize QGVRasterWarp::getSize() const
+{
+    return mSize;
+}
+
+bool QGVRasterWarp::isIdentity() const
+{
+    return mIdentity;
+}
+
+QImage QGVRasterWarp::warp(const QImage& source) const
+{
+    if (mIdentity || source.isNull()) {
+        return source;
+    }
+
+    const QImage input = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const float scaleX = static_cast<float>(input.width()) / mSize.width();
+    const float scaleY = static_cast<float>(input.height()) / mSize.height();
+
+    // Horizontal taps are shared by all rows
+    QVector<int> columnFrom(mSize.width());
+    QVector<int> columnTo(mSize.width());
+    QVector<quint32> columnWeight(mSize.width());
+    for (int column = 0; column < mSize.width(); ++column) {
+        const float pos = qBound(0.0f, (mColumns[column] + 0.5f) * scaleX - 0.5f, input.width() - 1.0f);
+        columnFrom[column] = static_cast<int>(pos);
+        columnTo[column] = qMin(columnFrom[column] + 1, input.width() - 1);
+        columnWeight[column] = static_cast<quint32>((pos - columnFrom[column]) * 256.0f);
+    }
+
+    QImage output(mSize, QImage::Format_ARGB32_Premultiplied);
+    for (int row = 0; row < mSize.height(); ++row) {
+        const float pos = qBound(0.0f, (mRows[row] + 0.5f) * scaleY - 0.5f, input.height() - 1.0f);
+        const int rowFrom = static_cast<int>(pos);
+        const int rowTo = qMin(rowFrom + 1, input.height() - 1);
+        const quint32 rowWeight = static_cast<quint32>((pos - rowFrom) * 256.0f);
+        const QRgb* lineFrom = reinterpret_cast<const QRgb*>(input.constScanLine(rowFrom));
+        const QRgb* lineTo = reinterpret_cast<const QRgb*>(input.constScanLine(rowTo));
+        QRgb* line = reinterpret_cast<QRgb*>(output.scanLine(row));
+        for (int column = 0; column < mSize.width(); ++column) {
+            const int from = columnFrom[column];
+            const int to = columnTo[column];
+            const quint32 weight = columnWeight[column];
+            const QRgb top = interpolate(lineFrom[from], lineFrom[to], weight);
+            const QRgb bottom = interpolate(lineTo[from], lineTo[to], weight);
+            line[column] = interpolate(top, bottom, rowWeight);
+        }
+    }
+    return output;
+}
+
+QVector<float> QGVRasterWarp::calculateLookup(const QGVProjection* source,
+                                              const QGVProjection* target,
+                                              const QGV::GeoRect& geoRect,
+                                              bool rows) const
+{
+    // Cylindrical projections are separable, so one lookup per row and per column is enough
+    const QRectF sourceRect = source->geoToProj(geoRect);
+    const QRectF targetRect = target->geoToProj(geoRect);
+    const int count = (rows) ? mSize.height() : mSize.width();
+    QVector<double> targetX(count, targetRect.center().x());
+    QVector<double> targetY(count, targetRect.center().y());
+    for (int i = 0; i < count; ++i) {
+        const double fraction = (i + 0.5) / count;
+        if (rows) {
+            targetY[i] = targetRect.top() + fraction * targetRect.height();
+        } else {
+            targetX[i] = targetRect.left() + fraction * targetRect.width();
+        }
+    }
+    QVector<double> lat(count);
+    QVector<double> lon(count);
+    target->projToGeo(targetX.constData(), targetY.constData(), lat.data(), lon.data(), count);
+    QVector<double> sourceX(count);
+    QVector<double> sourceY(count);
+    source->geoToProj(lat.constData(), lon.constData(), sourceX.data(), sourceY.data(), count);
+
+    QVector<float> lookup(count);
+    for (int i = 0; i < count; ++i) {
+        const double fraction = (rows) ? (sourceY[i] - sourceRect.top()) / sourceRect.height()
+                                       : (sourceX[i] - sourceRect.left()) / sourceRect.width();
+        lookup[i] = static_cast<float>(fraction * count - 0.5);
+    }
+    return lookup;
+}
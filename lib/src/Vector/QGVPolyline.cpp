@@ -0,0 +1,481 @@
+/***************************************************************************
+ * QGeoView is a Qt / C ++ widget for visualizing geographic data.
+ * Copyright (C) 2018-2024 Andrey Yaroshenko.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, see https://www.gnu.org/licenses.
+ ****************************************************************************/
+
+#include "Vector/QGVPolyline.h"
+
+#include <QPainter>
+#include <QtMath>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+const int maxLevelBand = 64;
+const int fullLevelBand = maxLevelBand + 1;
+const int noLevelBand = std::numeric_limits<int>::min();
+const int maxClipEntries = 4;
+
+struct SimplifyRange
+{
+    int first;
+    int last;
+    double limit;
+};
+
+double segmentDistance(const QPointF& point, const QPointF& segStart, const QPointF& segEnd)
+{
+    const QPointF segment = segEnd - segStart;
+    const double length2 = QPointF::dotProduct(segment, segment);
+    double t = (length2 > 0) ? QPointF::dotProduct(point - segStart, segment) / length2 : 0.0;
+    t = qBound(0.0, t, 1.0);
+    const QPointF delta = point - (segStart + t * segment);
+    return qSqrt(QPointF::dotProduct(delta, delta));
+}
+
+bool clipSegment(QPointF& segStart, QPointF& segEnd, const QRectF& rect)
+{
+    const QPointF origin = segStart;
+    const QPointF delta = segEnd - segStart;
+    const double p[4] = { -delta.x(), delta.x(), -delta.y(), delta.y() };
+    const double q[4] = { origin.x() - rect.left(), rect.right() - origin.x(), origin.y() - rect.top(),
+                          rect.bottom() - origin.y() };
+    double t0 = 0.0;
+    double t1 = 1.0;
+    for (int edge = 0; edge < 4; ++edge) {
+        if (p[edge] == 0.0) {
+            if (q[edge] < 0.0) {
+                return false;
+            }
+            continue;
+        }
+        const double t = q[edge] / p[edge];
+        if (p[edge] < 0.0) {
+            if (t > t1) {
+                return false;
+            }
+            t0 = qMax(t0, t);
+        } else {
+            if (t < t0) {
+                return false;
+            }
+            t1 = qMin(t1, t);
+        }
+    }
+    if (t1 < 1.0) {
+        segEnd = origin + t1 * delta;
+    }
+    if (t0 > 0.0) {
+        segStart = origin + t0 * delta;
+    }
+    return true;
+}
+
+bool isInsideEdge(const QPointF& point, const QRectF& rect, int edge)
+{
+    switch (edge) {
+        case 0:
+            return point.x() >= rect.left();
+        case 1:
+            return point.x() <= rect.right();
+        case 2:
+            return point.y() >= rect.top();
+        default:
+            return point.y() <= rect.bottom();
+    }
+}
+
+QPointF intersectEdge(const QPointF& from, const QPointF& to, const QRectF& rect, int edge)
+{
+    if (edge < 2) {
+        const double x = (edge == 0) ? rect.left() : rect.right();
+        const double t = (x - from.x()) / (to.x() - from.x());
+        return QPointF(x, from.y() + t * (to.y() - from.y()));
+    }
+    const double y = (edge == 2) ? rect.top() : rect.bottom();
+    const double t = (y - from.y()) / (to.y() - from.y());
+    return QPointF(from.x() + t * (to.x() - from.x()), y);
+}
+
+QPolygonF clipPolygon(const QPolygonF& projPoints, const QRectF& rect)
+{
+    // Sutherland-Hodgman, edges along clip rect stay outside of viewport
+    QPolygonF result = projPoints;
+    for (int edge = 0; edge < 4 && !result.isEmpty(); ++edge) {
+        QPolygonF input;
+        input.swap(result);
+        result.reserve(input.size());
+        QPointF prev = input.last();
+        bool prevInside = isInsideEdge(prev, rect, edge);
+        for (const QPointF& point : input) {
+            const bool inside = isInsideEdge(point, rect, edge);
+            if (inside != prevInside) {
+                result.append(intersectEdge(prev, point, rect, edge));
+            }
+            if (inside) {
+                result.append(point);
+            }
+            prev = point;
+            prevInside = inside;
+        }
+    }
+    return result;
+}
+}
+
+QGVPolyline::QGVPolyline()
+    : QGVPolyline(false)
+{
+}
+
+QGVPolyline::QGVPolyline(bool closed)
+    : mClosed{ closed }
+    , mPathBand{ noLevelBand }
+    , mPen{ QBrush(Qt::black), 1 }
+    , mSimplification{ 0.5 }
+    , mPreparedProjection{ nullptr }
+{
+    mPen.setCosmetic(true);
+}
+
+void QGVPolyline::setPoints(const QVector<QGV::GeoPos>& geoPoints)
+{
+    setPoints(QGV::GeoPosArray(geoPoints));
+}
+
+void QGVPolyline::setPoints(const QGV::GeoPosArray& geoPoints)
+{
+    mGeoPoints = geoPoints;
+    calculateGeometry();
+}
+
+QVector<QGV::GeoPos> QGVPolyline::getPoints() const
+{
+    return mGeoPoints.toVector();
+}
+
+const QGV::GeoPosArray& QGVPolyline::getPointArray() const
+{
+    return mGeoPoints;
+}
+
+void QGVPolyline::setPen(const QPen& pen)
+{
+    mPen = pen;
+    repaint();
+}
+
+QPen QGVPolyline::getPen() const
+{
+    return mPen;
+}
+
+void QGVPolyline::setSimplification(double pixels)
+{
+    mSimplification = pixels;
+    mLevels.clear();
+    mPathBand = noLevelBand;
+    mPath = {};
+    mClipCache.clear();
+    repaint();
+}
+
+double QGVPolyline::getSimplification() const
+{
+    return mSimplification;
+}
+
+void QGVPolyline::onProjectionPrepare(const QGVProjection* projection)
+{
+    projectGeometry(projection);
+    mPreparedProjection = projection;
+}
+
+void QGVPolyline::onProjection(QGVMap* geoMap)
+{
+    QGVDrawItem::onProjection(geoMap);
+    if (mPreparedProjection == geoMap->getProjection()) {
+        mPreparedProjection = nullptr;
+        resetBoundary();
+        refresh();
+        return;
+    }
+    calculateGeometry();
+}
+
+QPainterPath QGVPolyline::projShape() const
+{
+    return levelPath((mPathBand == noLevelBand) ? fullLevelBand : mPathBand);
+}
+
+QRectF QGVPolyline::projBoundingRect() const
+{
+    return mProjRect;
+}
+
+void QGVPolyline::projPaint(QPainter* painter)
+{
+    const QPainterPath& path = paintPath(getMap()->getCamera());
+    if (path.isEmpty()) {
+        return;
+    }
+    painter->setPen(mPen);
+    painter->setBrush(Qt::NoBrush);
+    painter->drawPath(path);
+}
+
+const QPainterPath& QGVPolyline::paintPath(const QGVCameraState& camera)
+{
+    const int band = levelBand(camera.scale());
+
+    // Path is drawn in item coordinates, so camera rect is mapped back through item transform
+    if (isFlag(QGV::ItemFlag::IgnoreScale)) {
+        return levelPath(band);
+    }
+    QRectF viewRect = camera.projRect();
+    const QTransform transform = effectiveTransform();
+    if (!transform.isIdentity()) {
+        if (!transform.isInvertible()) {
+            return levelPath(band);
+        }
+        viewRect = transform.inverted().mapRect(viewRect);
+    }
+
+    // Clip rect is snapped to view-sized cells, so the clipped path survives small camera moves
+    const double cell = qMax(viewRect.width(), viewRect.height());
+    if (cell <= 0) {
+        return levelPath(band);
+    }
+    const QRectF clipRect(QPointF(qFloor((viewRect.left() - cell / 2) / cell) * cell,
+                                  qFloor((viewRect.top() - cell / 2) / cell) * cell),
+                          QPointF(qCeil((viewRect.right() + cell / 2) / cell) * cell,
+                                  qCeil((viewRect.bottom() + cell / 2) / cell) * cell));
+    if (clipRect.contains(mProjRect)) {
+        return levelPath(band);
+    }
+
+    // One entry per clip rect, so world copies painted in the same frame do not evict each other
+    for (int i = 0; i < mClipCache.size(); ++i) {
+        if (mClipCache.at(i).band == band && mClipCache.at(i).rect == clipRect) {
+            if (i > 0) {
+                mClipCache.move(i, 0);
+            }
+            return mClipCache.first().path;
+        }
+    }
+    if (mClipCache.size() >= maxClipEntries) {
+        mClipCache.removeLast();
+    }
+    mClipCache.prepend({ band, clipRect, createClippedPath(levelPoints(band), clipRect) });
+    return mClipCache.first().path;
+}
+
+void QGVPolyline::calculateGeometry()
+{
+    if (getMap() == nullptr) {
+        return;
+    }
+
+    projectGeometry(getMap()->getProjection());
+    resetBoundary();
+    refresh();
+}
+
+void QGVPolyline::projectGeometry(const QGVProjection* projection)
+{
+    const int count = mGeoPoints.size();
+    mProjX.resize(count);
+    mProjY.resize(count);
+    mGeoPoints.toProj(projection, mProjX.data(), mProjY.data());
+    mProjRect = {};
+    if (count > 0) {
+        const auto xRange = std::minmax_element(mProjX.constBegin(), mProjX.constEnd());
+        const auto yRange = std::minmax_element(mProjY.constBegin(), mProjY.constEnd());
+        mProjRect = QRectF(QPointF(*xRange.first, *yRange.first), QPointF(*xRange.second, *yRange.second));
+    }
+    calculateSignificance();
+    mLevels.clear();
+    mPathBand = noLevelBand;
+    mPath = {};
+    mClipCache.clear();
+}
+
+void QGVPolyline::calculateSignificance()
+{
+    const int count = mProjX.size();
+    const float unlimited = std::numeric_limits<float>::infinity();
+    mSignificance.fill(0.0f, count);
+    if (count == 0) {
+        return;
+    }
+
+    // Douglas-Peucker significance: tolerance at which vertex disappears, monotone over the split tree
+    QVector<SimplifyRange> stack;
+    const double* x = mProjX.constData();
+    const double* y = mProjY.constData();
+    const auto point = [x, y](int index) { return QPointF(x[index], y[index]); };
+    float* significance = mSignificance.data();
+    significance[0] = unlimited;
+    if (mClosed && count > 2) {
+        int farIndex = 1;
+        double farDistance = -1;
+        for (int i = 1; i < count; ++i) {
+            const double distance = segmentDistance(point(i), point(0), point(0));
+            if (distance > farDistance) {
+                farDistance = distance;
+                farIndex = i;
+            }
+        }
+        significance[farIndex] = unlimited;
+        stack.append({ 0, farIndex, unlimited });
+        stack.append({ farIndex, count, unlimited });
+    } else {
+        significance[count - 1] = unlimited;
+        stack.append({ 0, count - 1, unlimited });
+    }
+
+    while (!stack.isEmpty()) {
+        const SimplifyRange range = stack.takeLast();
+        if (range.last - range.first < 2) {
+            continue;
+        }
+        const QPointF segStart = point(range.first % count);
+        const QPointF segEnd = point(range.last % count);
+        int maxIndex = range.first + 1;
+        double maxDistance = -1;
+        for (int i = range.first + 1; i < range.last; ++i) {
+            const double distance = segmentDistance(point(i), segStart, segEnd);
+            if (distance > maxDistance) {
+                maxDistance = distance;
+                maxIndex = i;
+            }
+        }
+        const double value = qMin(maxDistance, range.limit);
+        significance[maxIndex] = static_cast<float>(value);
+        stack.append({ range.first, maxIndex, value });
+        stack.append({ maxIndex, range.last, value });
+    }
+}
+
+int QGVPolyline::levelBand(double scale) const
+{
+    if (mSimplification <= 0 || scale <= 0) {
+        return fullLevelBand;
+    }
+    return qBound(-maxLevelBand, qCeil(qLn(scale) * M_LOG2E), maxLevelBand);
+}
+
+const QGVPolyline::Level& QGVPolyline::level(int band) const
+{
+    const auto iter = mLevels.constFind(band);
+    if (iter != mLevels.constEnd()) {
+        return iter.value();
+    }
+
+    // Level keeps only indices of surviving vertices, full level keeps nothing
+    const double tolerance = (band == fullLevelBand) ? 0.0 : std::ldexp(mSimplification, -band);
+    const int count = mSignificance.size();
+    const int kept = static_cast<int>(std::count_if(mSignificance.constBegin(), mSignificance.constEnd(),
+                                                    [tolerance](float value) { return value >= tolerance; }));
+    Level newLevel;
+    newLevel.full = (kept == count);
+    if (!newLevel.full) {
+        newLevel.indices.reserve(kept);
+        for (int i = 0; i < count; ++i) {
+            if (mSignificance.at(i) >= tolerance) {
+                newLevel.indices.append(i);
+            }
+        }
+    }
+    return *mLevels.insert(band, newLevel);
+}
+
+QPolygonF QGVPolyline::levelPoints(int band) const
+{
+    const Level& pointsLevel = level(band);
+    QPolygonF projPoints;
+    if (pointsLevel.full) {
+        projPoints.reserve(mProjX.size());
+        for (int i = 0; i < mProjX.size(); ++i) {
+            projPoints.append(QPointF(mProjX.at(i), mProjY.at(i)));
+        }
+    } else {
+        projPoints.reserve(pointsLevel.indices.size());
+        for (const int index : pointsLevel.indices) {
+            projPoints.append(QPointF(mProjX.at(index), mProjY.at(index)));
+        }
+    }
+    return projPoints;
+}
+
+const QPainterPath& QGVPolyline::levelPath(int band) const
+{
+    // Only path of the last used level is kept
+    if (band != mPathBand) {
+        mPath = createPath(levelPoints(band));
+        mPathBand = band;
+    }
+    return mPath;
+}
+
+QPainterPath QGVPolyline::createPath(const QPolygonF& projPoints) const
+{
+    QPainterPath path;
+    if (projPoints.isEmpty()) {
+        return path;
+    }
+    path.addPolygon(projPoints);
+    if (mClosed) {
+        path.closeSubpath();
+    }
+    return path;
+}
+
+QPainterPath QGVPolyline::createClippedPath(const QPolygonF& projPoints, const QRectF& clipRect) const
+{
+    if (mClosed) {
+        return createPath(clipPolygon(projPoints, clipRect));
+    }
+
+    QPainterPath path;
+    QPolygonF part;
+    const auto flushPart = [&path, &part]() {
+        if (part.size() > 1) {
+            path.addPolygon(part);
+        }
+        part.clear();
+    };
+    for (int i = 1; i < projPoints.size(); ++i) {
+        QPointF segStart = projPoints.at(i - 1);
+        QPointF segEnd = projPoints.at(i);
+        if (!clipSegment(segStart, segEnd, clipRect)) {
+            flushPart();
+            continue;
+        }
+        if (part.isEmpty() || part.last() != segStart) {
+            flushPart();
+            part.append(segStart);
+        }
+        part.append(segEnd);
+        if (segEnd != projPoints.at(i)) {
+            flushPart();
+        }
+    }
+    flushPart();
+    return path;
+}
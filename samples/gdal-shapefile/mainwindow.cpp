@@ -29,15 +29,16 @@
 #include "cpl_conv.h"
 #include "ogrsf_frmts.h"
 
-QList<QGV::GeoPos> convert(OGRPolygon* poPolygon)
+PointList convert(OGRPolygon* poPolygon)
 {
     OGRPoint ptTemp;
-    QList<QGV::GeoPos> result;
+    PointList result;
     OGRLinearRing* poExteriorRing = poPolygon->getExteriorRing();
     int NumberOfExteriorRingVertices = poExteriorRing->getNumPoints();
+    result.reserve(NumberOfExteriorRingVertices);
     for (int k = 0; k < NumberOfExteriorRingVertices; k++) {
         poExteriorRing->getPoint(k, &ptTemp);
-        result << QGV::GeoPos(ptTemp.getY(), ptTemp.getX());
+        result.append(ptTemp.getY(), ptTemp.getX());
     }
     return result;
 }
@@ -87,8 +88,8 @@ MainWindow::MainWindow()
             if (poGeometry != NULL && wkbFlatten(poGeometry->getGeometryType()) == wkbPolygon) {
                 OGRPolygon* poPolygon = (OGRPolygon*)poGeometry;
                 if (poPolygon->IsValid()) {
-                    QList<QGV::GeoPos> points = convert(poPolygon);
-                    if (points.count() > 2)
+                    PointList points = convert(poPolygon);
+                    if (points.size() > 2)
                         mMap->addItem(new Polygon(points, Qt::red, Qt::blue));
                 }
             } else if (poGeometry != NULL && wkbFlatten(poGeometry->getGeometryType()) == wkbMultiPolygon) {
@@ -96,8 +97,8 @@ MainWindow::MainWindow()
                 for (int i = 0; i < poMultiPolygon->getNumGeometries(); i++) {
                     OGRPolygon* poPolygon = (OGRPolygon*)poMultiPolygon->getGeometryRef(i);
                     if (poPolygon->IsValid()) {
-                        QList<QGV::GeoPos> points = convert(poPolygon);
-                        if (points.count() > 2)
+                        PointList points = convert(poPolygon);
+                        if (points.size() > 2)
                             mMap->addItem(new Polygon(points, Qt::red, Qt::blue));
                     }
                 }
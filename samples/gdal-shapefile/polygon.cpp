@@ -21,56 +21,13 @@
 #include <QPainter>
 
 Polygon::Polygon(const PointList& geoPoints, QColor stroke, QColor fill)
-    : mGeoPoints(geoPoints)
-    , mColorStroke(stroke)
-    , mColorFill(fill)
+    : mColorFill(fill)
 {
-}
-
-void Polygon::setPoints(const PointList& geoPoints)
-{
-    mGeoPoints = geoPoints;
-
-    // Geo coordinates need to be converted manually again to projection
-    onProjection(getMap());
-
-    // Now we can inform QGV about changes for this
-    resetBoundary();
-    refresh();
-}
-
-PointList Polygon::getPoints() const
-{
-    return mGeoPoints;
-}
-
-void Polygon::onProjection(QGVMap* geoMap)
-{
-    QGVDrawItem::onProjection(geoMap);
-    mProjPoints.clear();
-    for (const QGV::GeoPos& pos : mGeoPoints)
-        mProjPoints << geoMap->getProjection()->geoToProj(pos);
-}
-
-QPainterPath Polygon::projShape() const
-{
-    QPainterPath path;
-    path.addPolygon(mProjPoints);
-    return path;
-}
-
-void Polygon::projPaint(QPainter* painter)
-{
-    QPen pen = QPen(QBrush(mColorStroke), 1);
+    QPen pen = QPen(QBrush(stroke), 1);
     pen.setCosmetic(true);
-    painter->setPen(pen);
-    painter->setBrush(QBrush(mColorFill));
-    painter->drawPolygon(mProjPoints);
-}
-
-QPointF Polygon::projAnchor() const
-{
-    return mProjPoints.boundingRect().center();
+    setPen(pen);
+    setBrush(QBrush(mColorFill));
+    setPoints(geoPoints);
 }
 
 QTransform Polygon::projTransform() const
@@ -122,7 +79,7 @@ void Polygon::projOnMouseDoubleClick(const QPointF& projPos)
     const auto iter =
             std::find_if(colors.begin(), colors.end(), [this](const QColor& color) { return color == mColorFill; });
     mColorFill = colors[(iter - colors.begin() + 1) % colors.size()];
-    repaint();
+    setBrush(QBrush(mColorFill));
 
     setOpacity(1.0);
 
@@ -144,13 +101,16 @@ void Polygon::projOnObjectMovePos(const QPointF& projPos)
     // Custom reaction to mouse pos change when item move is started.
     // In this case actually changing location of object.
 
+    const QGVProjection* projection = getMap()->getProjection();
+    const PointList& points = getPointArray();
     PointList newPoints;
-    for (const QPointF& pt : mProjPoints)
-        newPoints << getMap()->getProjection()->projToGeo(pt + projPos);
+    newPoints.reserve(points.size());
+    for (int i = 0; i < points.size(); ++i)
+        newPoints.append(projection->projToGeo(projection->geoToProj(points.at(i)) + projPos));
 
     setPoints(newPoints);
 
-    qInfo() << "object moved" << mProjPoints;
+    qInfo() << "object moved" << projPos;
 }
 
 void Polygon::projOnObjectStopMove(const QPointF& projPos)
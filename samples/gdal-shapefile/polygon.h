@@ -18,28 +18,18 @@
 
 #pragma once
 
-#include <QGeoView/QGVDrawItem.h>
+#include <QGeoView/Vector/QGVPolygon.h>
 
-#include <QBrush>
-#include <QPen>
+typedef QGV::GeoPosArray PointList;
 
-typedef QList<QGV::GeoPos> PointList;
-
-class Polygon : public QGVDrawItem
+class Polygon : public QGVPolygon
 {
     Q_OBJECT
 
 public:
     explicit Polygon(const PointList& geoPoints, QColor stroke, QColor fill);
 
-    void setPoints(const PointList& geoPoints);
-    PointList getPoints() const;
-
 private:
-    void onProjection(QGVMap* geoMap) override;
-    QPainterPath projShape() const override;
-    void projPaint(QPainter* painter) override;
-    QPointF projAnchor() const override;
     QTransform projTransform() const override;
     QString projTooltip(const QPointF& projPos) const override;
     void projOnMouseClick(const QPointF& projPos) override;
@@ -49,8 +39,5 @@ private:
     void projOnObjectStopMove(const QPointF& projPos) override;
 
 private:
-    PointList mGeoPoints;
-    QPolygonF mProjPoints;
-    QColor mColorStroke;
     QColor mColorFill;
 };